@@ -0,0 +1,1885 @@
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include <errno.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "array_toolkit.h"
+
+// ---------------------- Function Definitions ---------------------- //
+
+// Checks if a position is valid within the array range
+bool isValid(const int arr[], int length, int pos) {
+    (void)arr;                          // Only the length matters; kept for the demo's call sites
+    return (pos >= 0 && pos < length);  // Valid position is within the range [0, length-1]
+}
+
+// Removes an element at a specific position and shifts the elements within the array
+void remove_element(int arr[], int length, int pos) {
+    if (!isValid(arr, length, pos)) {
+        printf("[ERROR] Invalid position: %d. Operation failed.\n", pos);
+        return;
+    }
+
+    shift_remove(arr, pos);
+
+    printf("[SYS] Element at index %d has been successfully removed.\n", pos);
+}
+
+// Inserts an element at a specific position and shifts the elements within the array
+void insert_element(int arr[], int length, int pos, int value) {
+    if (!isValid(arr, length, pos)) {
+        printf("[ERROR] Insertion at index %d is out of bounds. Operation halted.\n", pos);
+        return;
+    }
+
+    shift_insert(arr, pos, value);
+
+    printf("[SYS] The Value -> %d has been successfully inserted at index %d.\n", value, pos);
+}
+
+// Shifts the elements in front of pos one slot to the right (silent, no bounds check)
+void shift_remove(int arr[], int pos) {
+    for (int i = pos; i > 0; i--) {
+        arr[i] = arr[i - 1];
+    }
+}
+
+// Shifts the elements in front of pos one slot to the left and stores value at pos (silent, no bounds check)
+void shift_insert(int arr[], int pos, int value) {
+    for (int i = 0; i < pos; i++) {
+        arr[i] = arr[i + 1];
+    }
+    arr[pos] = value;
+}
+
+// Here we reshape a 1D array into a 2D array with specific dimensions
+void reshape(const int arr[], int length, int nRows, int nCols, int arr2d[nRows][nCols]) {
+    if (length != nRows * nCols) {
+        printf("[ERROR] Dimensions %dx%d are incompatible with array length.\n", nRows, nCols);
+        return;
+    }
+
+    // Column-major fill order: a view over arr, copied out row by row into arr2d
+    int_view_t flat = view_from_array(arr, length);
+    int_view_t shaped;
+    if (!view_reshape(&flat, nRows, nCols, ORDER_COL_MAJOR, &shaped)) {
+        return; // view_reshape has reported why
+    }
+    view_materialize_parallel(&shaped, ORDER_ROW_MAJOR, &arr2d[0][0]);
+
+    printf("[SYS] Array successfully restructured to %dx%d format.\n", nRows, nCols);
+}
+
+// Transposes a matrix as needed
+void trans_matrix(int nRows, int nCols, const int mat[nRows][nCols], int mat_transp[nCols][nRows]) {
+    transpose_parallel(nRows, nCols, &mat[0][0], &mat_transp[0][0]);
+
+    printf("[SYS] Matrix transposition complete.\n");
+}
+
+// Transposes a flat row-major matrix with the original row-by-row loop (silent)
+void trans_matrix_naive(int nRows, int nCols, const int *mat, int *mat_transp) {
+    for (int i = 0; i < nRows; i++) {
+        for (int j = 0; j < nCols; j++) {
+            mat_transp[(size_t)j * nRows + i] = mat[(size_t)i * nCols + j];
+        }
+    }
+}
+
+// Checks for duplicate values within the array
+bool found_duplicate(const int arr[], int length) {
+    dup_report_t report;
+    if (!find_duplicates_parallel(arr, length, &report)) {
+        return found_duplicate_naive(arr, length);   // Falls back to the nested loop if the engine cannot allocate
+    }
+    return report.found;
+}
+
+// Checks for duplicate values with the original O(n^2) nested loop
+bool found_duplicate_naive(const int arr[], int length) {
+    for (int i = 0; i < length - 1; i++) {
+        for (int j = i + 1; j < length; j++) {
+            if (arr[i] == arr[j]) {
+                return true;    // True if duplicates are identified
+            }
+        }
+    }
+    return false;    // false if no duplicates are found
+}
+
+// Prints a 1D array
+void printArray(const int arr[], int length) {
+    out_buffer_t *out = out_stdout();
+    if (out == NULL) {
+        for (int i = 0; i < length; i++) {
+            printf("%d ", arr[i]);
+        }
+        printf("\n");
+        return;
+    }
+    fflush(stdout);    // Keeps earlier printf output ahead of the raw write(2)
+    out_print_row(out, arr, length);
+    out_flush(out);
+}
+
+// Prints a 2D array
+void print2DArray(int nRows, int nCols, const int arr2d[nRows][nCols]) {
+    out_buffer_t *out = out_stdout();
+    if (out == NULL) {
+        for (int i = 0; i < nRows; i++) {
+            for (int j = 0; j < nCols; j++) {
+                printf("%d ", arr2d[i][j]);
+            }
+            printf("\n");
+        }
+        return;
+    }
+    fflush(stdout);
+    out_print_matrix(out, nRows, nCols, &arr2d[0][0]);
+    out_flush(out);
+}
+
+// ---------------------- Growable Sequence (Gap Buffer) ---------------------- //
+
+// Allocates an empty sequence with room for at least capacity elements
+bool seq_init(int_seq_t *seq, int capacity) {
+    if (capacity < 16) {
+        capacity = 16;
+    }
+    seq->data = malloc((size_t)capacity * sizeof(int));
+    if (seq->data == NULL) {
+        printf("[ERROR] Unable to allocate a sequence of %d elements.\n", capacity);
+        seq->capacity = seq->gap_start = seq->gap_end = 0;
+        return false;
+    }
+    seq->capacity = capacity;
+    seq->gap_start = 0;          // The whole buffer starts out as gap
+    seq->gap_end = capacity;
+    return true;
+}
+
+// Releases the sequence storage
+void seq_free(int_seq_t *seq) {
+    free(seq->data);
+    seq->data = NULL;
+    seq->capacity = seq->gap_start = seq->gap_end = 0;
+}
+
+// Number of stored elements (everything outside the gap)
+int seq_length(const int_seq_t *seq) {
+    return seq->capacity - (seq->gap_end - seq->gap_start);
+}
+
+// Reads the element at a logical position, skipping over the gap
+int seq_get(const int_seq_t *seq, int pos) {
+    return (pos < seq->gap_start) ? seq->data[pos] : seq->data[pos + (seq->gap_end - seq->gap_start)];
+}
+
+// Overwrites the element at a logical position
+void seq_set(int_seq_t *seq, int pos, int value) {
+    if (pos < seq->gap_start) {
+        seq->data[pos] = value;
+    } else {
+        seq->data[pos + (seq->gap_end - seq->gap_start)] = value;
+    }
+}
+
+// Moves the gap so that it starts at the logical position pos
+static void seq_move_gap(int_seq_t *seq, int pos) {
+    if (pos < seq->gap_start) {
+        int moved = seq->gap_start - pos;
+        par_memmove(&seq->data[seq->gap_end - moved], &seq->data[pos], (size_t)moved * sizeof(int));
+        seq->gap_start -= moved;
+        seq->gap_end -= moved;
+    } else if (pos > seq->gap_start) {
+        int moved = pos - seq->gap_start;
+        par_memmove(&seq->data[seq->gap_start], &seq->data[seq->gap_end], (size_t)moved * sizeof(int));
+        seq->gap_start += moved;
+        seq->gap_end += moved;
+    }
+}
+
+// Makes sure the gap can hold at least count more elements (doubles the storage when it cannot)
+static bool seq_reserve_gap(int_seq_t *seq, int count) {
+    if (seq->gap_end - seq->gap_start >= count) {
+        return true;
+    }
+
+    int length = seq_length(seq);
+    int new_capacity = seq->capacity * 2;
+    if (new_capacity < length + count) {
+        new_capacity = length + count;
+    }
+
+    int *grown = realloc(seq->data, (size_t)new_capacity * sizeof(int));
+    if (grown == NULL) {
+        printf("[ERROR] Unable to grow the sequence to %d elements.\n", new_capacity);
+        return false;
+    }
+
+    // Slides the elements after the gap to the end of the enlarged storage
+    int tail = seq->capacity - seq->gap_end;
+    par_memmove(&grown[new_capacity - tail], &grown[seq->gap_end], (size_t)tail * sizeof(int));
+    seq->data = grown;
+    seq->gap_end = new_capacity - tail;
+    seq->capacity = new_capacity;
+    return true;
+}
+
+// Copies count values into the gap at pos (positions are already validated)
+static bool seq_splice_in(int_seq_t *seq, int pos, const int values[], int count) {
+    if (!seq_reserve_gap(seq, count)) {
+        return false;
+    }
+    seq_move_gap(seq, pos);
+    par_memcpy(&seq->data[seq->gap_start], values, (size_t)count * sizeof(int));
+    seq->gap_start += count;
+    return true;
+}
+
+// Inserts a single value before pos, using the same bounds rules as insert_element
+bool seq_insert(int_seq_t *seq, int pos, int value) {
+    return seq_insert_range(seq, pos, &value, 1);
+}
+
+// Removes the value at pos, using the same bounds rules as remove_element
+bool seq_remove(int_seq_t *seq, int pos) {
+    return seq_remove_range(seq, pos, 1);
+}
+
+// Inserts a whole range of values before pos in a single gap move
+bool seq_insert_range(int_seq_t *seq, int pos, const int values[], int count) {
+    if (!isValid(seq->data, seq_length(seq), pos)) {
+        printf("[ERROR] Insertion at index %d is out of bounds. Operation halted.\n", pos);
+        return false;
+    }
+    if (count <= 0) {
+        return count == 0;
+    }
+    return seq_splice_in(seq, pos, values, count);
+}
+
+// Removes count values starting at pos by widening the gap over them
+bool seq_remove_range(int_seq_t *seq, int pos, int count) {
+    int length = seq_length(seq);
+    if (!isValid(seq->data, length, pos) || count < 0 || count > length - pos) {
+        printf("[ERROR] Invalid position: %d. Operation failed.\n", pos);
+        return false;
+    }
+    seq_move_gap(seq, pos);
+    seq->gap_end += count;
+    return true;
+}
+
+// Appends a range of values after the last element
+bool seq_append(int_seq_t *seq, const int values[], int count) {
+    if (count <= 0) {
+        return count == 0;
+    }
+    return seq_splice_in(seq, seq_length(seq), values, count);
+}
+
+// Copies the sequence into a flat array of seq_length elements
+void seq_to_array(const int_seq_t *seq, int out[]) {
+    int tail = seq->capacity - seq->gap_end;
+    par_memcpy(out, seq->data, (size_t)seq->gap_start * sizeof(int));
+    par_memcpy(&out[seq->gap_start], &seq->data[seq->gap_end], (size_t)tail * sizeof(int));
+}
+
+// ---------------------- Duplicate Detection Engine ---------------------- //
+
+#define DUP_RADIX_MIN_LENGTH (1 << 22)   // From this length on the radix sort beats the cache-missing hash set
+#define DUP_BITMAP_RANGE_FACTOR 64       // Bitmap is used when (max - min + 1) <= factor * length
+#define DUP_BITMAP_MAX_RANGE (1 << 28)   // Upper bound on bitmap size (2 x 32 MB)
+
+// Hash set slot: the value, and 1-based indices of its first and second occurrence (first == 0 means empty)
+typedef struct {
+    int key;
+    int first;
+    int second;
+} dup_slot_t;
+
+// Records one repeat of a value whose first two occurrences are at i and j
+static void dup_note_pair(dup_report_t *report, int i, int j) {
+    if (!report->found || i < report->first_i) {
+        report->found = true;
+        report->first_i = i;
+        report->first_j = j;
+    }
+}
+
+// Open-addressing hash set with linear probing, table kept at most half full
+// (indices gives the original position of each value, or NULL when values is the array itself)
+static bool dup_scan_hash(const int values[], const int indices[], int length, dup_report_t *report) {
+    int bits = 4;
+    while ((1 << bits) < 2 * length) {
+        bits++;
+    }
+    unsigned int mask = (1u << bits) - 1;
+    dup_slot_t *slots = calloc((size_t)mask + 1, sizeof(dup_slot_t));
+    if (slots == NULL) {
+        return false;
+    }
+
+    for (int j = 0; j < length; j++) {
+        unsigned int x = (unsigned int)values[j];
+        unsigned int h = ((x ^ (x >> 16)) * 0x45d9f3bu) >> (32 - bits);
+        int pos = (indices != NULL) ? indices[j] : j;
+        while (slots[h].first != 0 && slots[h].key != values[j]) {
+            h = (h + 1) & mask;
+        }
+        if (slots[h].first == 0) {
+            slots[h].key = values[j];
+            slots[h].first = pos + 1;
+        } else {
+            report->duplicate_count++;
+            if (slots[h].second == 0) {
+                slots[h].second = pos + 1;
+                dup_note_pair(report, slots[h].first - 1, pos);
+            }
+        }
+    }
+
+    free(slots);
+    return true;
+}
+
+// LSD radix sort of (value, index) pairs, then equal values sit next to each other in index order
+static bool dup_scan_radix(const int arr[], int length, dup_report_t *report) {
+    uint64_t *keys = malloc((size_t)length * sizeof(uint64_t));
+    uint64_t *scratch = malloc((size_t)length * sizeof(uint64_t));
+    if (keys == NULL || scratch == NULL) {
+        free(keys);
+        free(scratch);
+        return false;
+    }
+
+    // Flipping the sign bit makes the unsigned order match the signed order
+    for (int i = 0; i < length; i++) {
+        keys[i] = ((uint64_t)((uint32_t)arr[i] ^ 0x80000000u) << 32) | (uint32_t)i;
+    }
+
+    for (int shift = 32; shift < 64; shift += 8) {
+        int count[256] = {0};
+        for (int i = 0; i < length; i++) {
+            count[(keys[i] >> shift) & 0xFF]++;
+        }
+        if (count[(keys[0] >> shift) & 0xFF] == length) {
+            continue;    // Every key shares this byte, the pass would not move anything
+        }
+
+        int offset = 0;
+        for (int b = 0; b < 256; b++) {
+            int c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+        for (int i = 0; i < length; i++) {
+            scratch[count[(keys[i] >> shift) & 0xFF]++] = keys[i];
+        }
+        uint64_t *swap = keys;
+        keys = scratch;
+        scratch = swap;
+    }
+
+    // Adjacent compare: each run of equal values holds its indices in ascending order
+    for (int i = 1; i < length; i++) {
+        if ((keys[i] >> 32) == (keys[i - 1] >> 32)) {
+            report->duplicate_count++;
+            if (i == 1 || (keys[i - 2] >> 32) != (keys[i] >> 32)) {
+                dup_note_pair(report, (int)(uint32_t)keys[i - 1], (int)(uint32_t)keys[i]);
+            }
+        }
+    }
+
+    free(keys);
+    free(scratch);
+    return true;
+}
+
+// Two bitmaps over [min, max]: values seen once, and values seen more than once
+static bool dup_scan_bitmap(const int arr[], int length, int min, int64_t range, dup_report_t *report) {
+    size_t words = (size_t)((range + 63) / 64);
+    uint64_t *seen = calloc(words * 2, sizeof(uint64_t));
+    if (seen == NULL) {
+        return false;
+    }
+    uint64_t *repeated = seen + words;
+
+    for (int i = 0; i < length; i++) {
+        uint32_t bit = (uint32_t)arr[i] - (uint32_t)min;
+        uint64_t m = 1ull << (bit & 63);
+        if (seen[bit >> 6] & m) {
+            report->duplicate_count++;
+            repeated[bit >> 6] |= m;
+        }
+        seen[bit >> 6] |= m;
+    }
+
+    // The first index holding a repeated value is the first_i of the nested loop
+    for (int i = 0; report->duplicate_count > 0 && i < length; i++) {
+        uint32_t bit = (uint32_t)arr[i] - (uint32_t)min;
+        if (repeated[bit >> 6] & (1ull << (bit & 63))) {
+            int j = i + 1;
+            while (arr[j] != arr[i]) {
+                j++;
+            }
+            dup_note_pair(report, i, j);
+            break;
+        }
+    }
+
+    free(seen);
+    return true;
+}
+
+// Scans arr for duplicates with the requested strategy; returns false only if memory runs out
+bool find_duplicates(const int arr[], int length, dup_strategy_t strategy, dup_report_t *report) {
+    report->found = false;
+    report->first_i = report->first_j = -1;
+    report->duplicate_count = 0;
+    report->strategy = strategy;
+    if (length < 2) {
+        return true;
+    }
+
+    int min = arr[0], max = arr[0];
+    if (strategy == DUP_AUTO || strategy == DUP_BITMAP) {
+        for (int i = 1; i < length; i++) {
+            if (arr[i] < min) min = arr[i];
+            if (arr[i] > max) max = arr[i];
+        }
+    }
+    int64_t range = (int64_t)max - min + 1;
+
+    if (strategy == DUP_AUTO) {
+        if (range <= DUP_BITMAP_MAX_RANGE && range <= (int64_t)DUP_BITMAP_RANGE_FACTOR * length) {
+            strategy = DUP_BITMAP;
+        } else if (length >= DUP_RADIX_MIN_LENGTH) {
+            strategy = DUP_RADIX;
+        } else {
+            strategy = DUP_HASH;
+        }
+    } else if (strategy == DUP_BITMAP && range > DUP_BITMAP_MAX_RANGE) {
+        strategy = DUP_HASH;    // Value range too wide for a bitmap
+    }
+    report->strategy = strategy;
+
+    switch (strategy) {
+        case DUP_BITMAP: return dup_scan_bitmap(arr, length, min, range, report);
+        case DUP_RADIX: return dup_scan_radix(arr, length, report);
+        default: return dup_scan_hash(arr, NULL, length, report);
+    }
+}
+
+// ---------------------- Cache-Blocked Transpose ---------------------- //
+
+#define TRANSPOSE_TILE 64                // Tile edge in elements: a 64x64 int tile is 16 KB per side
+
+// Transposes one 8x8 block from src (row stride src_stride) into dst (row stride dst_stride), portable version
+static void transpose_8x8_scalar(const int *src, int src_stride, int *dst, int dst_stride) {
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 8; j++) {
+            dst[j * dst_stride + i] = src[i * src_stride + j];
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+// Transposes one 4x4 block with SSE2 unpack shuffles
+static inline void transpose_4x4_sse2(const int *src, int src_stride, int *dst, int dst_stride) {
+    __m128i r0 = _mm_loadu_si128((const __m128i *)&src[0 * src_stride]);
+    __m128i r1 = _mm_loadu_si128((const __m128i *)&src[1 * src_stride]);
+    __m128i r2 = _mm_loadu_si128((const __m128i *)&src[2 * src_stride]);
+    __m128i r3 = _mm_loadu_si128((const __m128i *)&src[3 * src_stride]);
+
+    __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+    __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+    __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+    __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+
+    _mm_storeu_si128((__m128i *)&dst[0 * dst_stride], _mm_unpacklo_epi64(t0, t1));
+    _mm_storeu_si128((__m128i *)&dst[1 * dst_stride], _mm_unpackhi_epi64(t0, t1));
+    _mm_storeu_si128((__m128i *)&dst[2 * dst_stride], _mm_unpacklo_epi64(t2, t3));
+    _mm_storeu_si128((__m128i *)&dst[3 * dst_stride], _mm_unpackhi_epi64(t2, t3));
+}
+
+// Transposes one 8x8 block as four SSE2 4x4 blocks
+static void transpose_8x8_sse2(const int *src, int src_stride, int *dst, int dst_stride) {
+    transpose_4x4_sse2(src, src_stride, dst, dst_stride);
+    transpose_4x4_sse2(src + 4, src_stride, dst + 4 * dst_stride, dst_stride);
+    transpose_4x4_sse2(src + 4 * src_stride, src_stride, dst + 4, dst_stride);
+    transpose_4x4_sse2(src + 4 * src_stride + 4, src_stride, dst + 4 * dst_stride + 4, dst_stride);
+}
+
+// Transposes one 8x8 block entirely in AVX2 registers (unpack 32, unpack 64, then swap 128-bit lanes)
+__attribute__((target("avx2")))
+static void transpose_8x8_avx2(const int *src, int src_stride, int *dst, int dst_stride) {
+    __m256i r[8], t[8], u[8];
+    for (int i = 0; i < 8; i++) {
+        r[i] = _mm256_loadu_si256((const __m256i *)&src[i * src_stride]);
+    }
+    for (int i = 0; i < 8; i += 2) {
+        t[i] = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+        t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+    }
+    for (int i = 0; i < 8; i += 4) {
+        u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+        u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+        u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+        u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+    for (int i = 0; i < 4; i++) {
+        _mm256_storeu_si256((__m256i *)&dst[i * dst_stride], _mm256_permute2x128_si256(u[i], u[i + 4], 0x20));
+        _mm256_storeu_si256((__m256i *)&dst[(i + 4) * dst_stride], _mm256_permute2x128_si256(u[i], u[i + 4], 0x31));
+    }
+}
+#endif
+
+static void (*transpose_kernel_picked)(const int *, int, int *, int) = NULL;
+static pthread_once_t transpose_kernel_once = PTHREAD_ONCE_INIT;
+
+// Picks the widest 8x8 micro-kernel the running CPU supports
+static void transpose_kernel_pick(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    transpose_kernel_picked = __builtin_cpu_supports("avx2") ? transpose_8x8_avx2 : transpose_8x8_sse2;
+#else
+    transpose_kernel_picked = transpose_8x8_scalar;
+#endif
+}
+
+// The picked micro-kernel; the check runs once, even when pool threads ask for it first
+static void (*transpose_kernel(void))(const int *, int, int *, int) {
+    pthread_once(&transpose_kernel_once, transpose_kernel_pick);
+    return transpose_kernel_picked;
+}
+
+// Name of the micro-kernel in use, for reports
+const char *transpose_kernel_name(void) {
+    void (*kernel)(const int *, int, int *, int) = transpose_kernel();
+#if defined(__x86_64__) || defined(__i386__)
+    if (kernel == transpose_8x8_avx2) return "AVX2";
+    if (kernel == transpose_8x8_sse2) return "SSE2";
+#endif
+    return (kernel == transpose_8x8_scalar) ? "scalar" : "unknown";
+}
+
+// Tiled out-of-place transpose of a row-major nRows x nCols matrix into nCols x nRows
+void transpose_blocked(int nRows, int nCols, const int *mat, int *mat_transp) {
+    transpose_strided(nRows, nCols, mat, nCols, mat_transp, nRows);
+}
+
+// Tiled transpose of an nRows x nCols block whose rows are src_stride apart, into rows dst_stride apart
+void transpose_strided(int nRows, int nCols, const int *src, int src_stride, int *dst, int dst_stride) {
+    void (*kernel)(const int *, int, int *, int) = transpose_kernel();
+
+    for (int ti = 0; ti < nRows; ti += TRANSPOSE_TILE) {
+        int ti_end = (ti + TRANSPOSE_TILE < nRows) ? ti + TRANSPOSE_TILE : nRows;
+        for (int tj = 0; tj < nCols; tj += TRANSPOSE_TILE) {
+            int tj_end = (tj + TRANSPOSE_TILE < nCols) ? tj + TRANSPOSE_TILE : nCols;
+
+            // Full 8x8 blocks go through the micro-kernel, ragged edges through the scalar loop
+            int i = ti;
+            for (; i + 8 <= ti_end; i += 8) {
+                int j = tj;
+                for (; j + 8 <= tj_end; j += 8) {
+                    kernel(&src[(size_t)i * src_stride + j], src_stride, &dst[(size_t)j * dst_stride + i], dst_stride);
+                }
+                for (int r = i; r < i + 8; r++) {
+                    for (int c = j; c < tj_end; c++) {
+                        dst[(size_t)c * dst_stride + r] = src[(size_t)r * src_stride + c];
+                    }
+                }
+            }
+            for (; i < ti_end; i++) {
+                for (int c = tj; c < tj_end; c++) {
+                    dst[(size_t)c * dst_stride + i] = src[(size_t)i * src_stride + c];
+                }
+            }
+        }
+    }
+}
+
+// In-place transpose of a square n x n matrix: swaps mirrored 8x8 blocks through a small stack buffer
+void transpose_square_inplace(int n, int *mat) {
+    void (*kernel)(const int *, int, int *, int) = transpose_kernel();
+    int full = n - n % 8;
+    int tmp[64];
+
+    for (int ti = 0; ti < full; ti += TRANSPOSE_TILE) {
+        int ti_end = (ti + TRANSPOSE_TILE < full) ? ti + TRANSPOSE_TILE : full;
+        for (int tj = ti; tj < full; tj += TRANSPOSE_TILE) {
+            int tj_end = (tj + TRANSPOSE_TILE < full) ? tj + TRANSPOSE_TILE : full;
+
+            for (int i = ti; i < ti_end; i += 8) {
+                for (int j = (tj == ti) ? i : tj; j < tj_end; j += 8) {
+                    int *a = &mat[(size_t)i * n + j];
+                    int *b = &mat[(size_t)j * n + i];
+                    kernel(a, n, tmp, 8);           // tmp = A^T
+                    if (a != b) {
+                        kernel(b, n, a, n);         // A = B^T
+                    }
+                    for (int r = 0; r < 8; r++) {   // B = old A^T
+                        memcpy(&b[(size_t)r * n], &tmp[r * 8], 8 * sizeof(int));
+                    }
+                }
+            }
+        }
+    }
+
+    // Leftover rows/columns that do not fill an 8x8 block
+    for (int i = 0; i < n; i++) {
+        for (int j = (i > full ? i + 1 : full); j < n; j++) {
+            int t = mat[(size_t)i * n + j];
+            mat[(size_t)i * n + j] = mat[(size_t)j * n + i];
+            mat[(size_t)j * n + i] = t;
+        }
+    }
+}
+
+// In-place transpose of a non-square nRows x nCols matrix by following permutation cycles
+bool transpose_inplace(int nRows, int nCols, int *mat) {
+    if (nRows == nCols) {
+        transpose_square_inplace(nRows, mat);
+        return true;
+    }
+
+    size_t total = (size_t)nRows * nCols;
+    if (total < 3) {
+        return true;    // A 1x1, 1x2 or 2x1 matrix has the same memory layout transposed
+    }
+
+    // One bit per element marks positions already written (1/32 of a second buffer)
+    uint64_t *done = calloc((total + 63) / 64, sizeof(uint64_t));
+    if (done == NULL) {
+        printf("[ERROR] Unable to allocate the transpose cycle bitmap.\n");
+        return false;
+    }
+
+    // Element at row-major index k moves to (k * nRows) mod (total - 1); 0 and total - 1 stay put
+    size_t modulus = total - 1;
+    for (size_t start = 1; start < modulus; start++) {
+        if (done[start >> 6] & (1ull << (start & 63))) {
+            continue;
+        }
+        size_t k = start;
+        int carried = mat[start];
+        do {
+            size_t next = (size_t)(((uint64_t)k * (uint64_t)nRows) % modulus);
+            int displaced = mat[next];
+            mat[next] = carried;
+            carried = displaced;
+            done[next >> 6] |= 1ull << (next & 63);
+            k = next;
+        } while (k != start);
+    }
+
+    free(done);
+    return true;
+}
+
+// ---------------------- Strided Views ---------------------- //
+
+// Wraps a flat array as a 1D view without copying
+int_view_t view_from_array(const int arr[], int length) {
+    int_view_t view = {arr, 1, {length, 1}, {1, 0}, 0};
+    return view;
+}
+
+// Wraps a flat array as a contiguous 2D view in the given element order
+int_view_t view_from_matrix(const int mat[], int nRows, int nCols, view_order_t order) {
+    int_view_t view = {mat, 2, {nRows, nCols}, {0, 0}, 0};
+    if (order == ORDER_ROW_MAJOR) {
+        view.strides[0] = nCols;
+        view.strides[1] = 1;
+    } else {
+        view.strides[0] = 1;
+        view.strides[1] = nRows;
+    }
+    return view;
+}
+
+// Number of elements covered by the view
+size_t view_size(const int_view_t *view) {
+    return (view->rank == 1) ? (size_t)view->shape[0] : (size_t)view->shape[0] * view->shape[1];
+}
+
+// Reads element (row, col) of a 2D view, or element row of a 1D view
+int view_at(const int_view_t *view, int row, int col) {
+    ptrdiff_t idx = view->offset + row * view->strides[0];
+    if (view->rank == 2) {
+        idx += col * view->strides[1];
+    }
+    return view->base[idx];
+}
+
+// Checks whether the view walks its buffer contiguously in the given order
+bool view_is_contiguous(const int_view_t *view, view_order_t order) {
+    if (view->rank == 1) {
+        return view->strides[0] == 1;
+    }
+    if (order == ORDER_ROW_MAJOR) {
+        return view->strides[1] == 1 && view->strides[0] == view->shape[1];
+    }
+    return view->strides[0] == 1 && view->strides[1] == view->shape[0];
+}
+
+// Reinterprets a view as nRows x nCols in O(1); the source must be contiguous when read in the given order
+bool view_reshape(const int_view_t *src, int nRows, int nCols, view_order_t order, int_view_t *out) {
+    if (view_size(src) != (size_t)nRows * nCols) {
+        printf("[ERROR] Dimensions %dx%d are incompatible with array length.\n", nRows, nCols);
+        return false;
+    }
+
+    // A linear walk of the source with a fixed step is all a reshape needs
+    ptrdiff_t step;
+    if (src->rank == 1) {
+        step = src->strides[0];
+    } else if (view_is_contiguous(src, ORDER_ROW_MAJOR)) {
+        step = 1;
+    } else {
+        printf("[ERROR] View is not contiguous; materialize it before reshaping.\n");
+        return false;
+    }
+
+    out->base = src->base;
+    out->rank = 2;
+    out->shape[0] = nRows;
+    out->shape[1] = nCols;
+    out->offset = src->offset;
+    if (order == ORDER_ROW_MAJOR) {
+        out->strides[0] = step * nCols;
+        out->strides[1] = step;
+    } else {
+        out->strides[0] = step;
+        out->strides[1] = step * nRows;
+    }
+    return true;
+}
+
+// Swaps the axes of a 2D view in O(1)
+int_view_t view_transpose(const int_view_t *src) {
+    int_view_t out = *src;
+    if (src->rank == 2) {
+        out.shape[0] = src->shape[1];
+        out.shape[1] = src->shape[0];
+        out.strides[0] = src->strides[1];
+        out.strides[1] = src->strides[0];
+    }
+    return out;
+}
+
+// Selects rows [row0, row0 + nRows) and columns [col0, col0 + nCols) of a 2D view in O(1)
+bool view_slice(const int_view_t *src, int row0, int nRows, int col0, int nCols, int_view_t *out) {
+    if (src->rank != 2 || row0 < 0 || col0 < 0 || nRows < 0 || nCols < 0 ||
+        row0 + nRows > src->shape[0] || col0 + nCols > src->shape[1]) {
+        printf("[ERROR] Slice [%d+%d, %d+%d] is outside the view.\n", row0, nRows, col0, nCols);
+        return false;
+    }
+    *out = *src;
+    out->shape[0] = nRows;
+    out->shape[1] = nCols;
+    out->offset += row0 * src->strides[0] + col0 * src->strides[1];
+    return true;
+}
+
+// Copies the view into a contiguous buffer laid out in the given order
+void view_materialize(const int_view_t *view, view_order_t order, int out[]) {
+    const int *origin = view->base + view->offset;
+    size_t total = view_size(view);
+    if (total == 0) {
+        return;
+    }
+
+    // Layout already matches: one memcpy
+    if (view_is_contiguous(view, order)) {
+        memcpy(out, origin, total * sizeof(int));
+        return;
+    }
+    if (view->rank == 1) {
+        for (int i = 0; i < view->shape[0]; i++) {
+            out[i] = origin[i * view->strides[0]];
+        }
+        return;
+    }
+
+    int rows = view->shape[0], cols = view->shape[1];
+    if (order == ORDER_COL_MAJOR) {
+        // Column-major output of this view is row-major output of its transpose
+        int_view_t flipped = view_transpose(view);
+        view_materialize(&flipped, ORDER_ROW_MAJOR, out);
+        return;
+    }
+
+    if (view->strides[1] == 1) {
+        // Rows are contiguous (e.g. a slice): one memcpy per row
+        for (int r = 0; r < rows; r++) {
+            memcpy(&out[(size_t)r * cols], origin + r * view->strides[0], (size_t)cols * sizeof(int));
+        }
+    } else if (view->strides[0] == 1 && view->strides[1] >= rows) {
+        // Columns are contiguous runs of a row-major source: a tiled transpose
+        transpose_strided(cols, rows, origin, (int)view->strides[1], out, cols);
+    } else {
+        for (int r = 0; r < rows; r++) {
+            for (int c = 0; c < cols; c++) {
+                out[(size_t)r * cols + c] = origin[r * view->strides[0] + c * view->strides[1]];
+            }
+        }
+    }
+}
+
+// ---------------------- Work-Stealing Thread Pool ---------------------- //
+
+#define PAR_DEFAULT_THRESHOLD (1 << 18)  // Inputs below this many elements stay on the calling thread
+#define PAR_TASKS_PER_THREAD 4           // Over-splitting factor so idle threads have something to steal
+
+// One queued unit of work: fn(arg, index)
+typedef struct {
+    void (*fn)(void *arg, int index);
+    void *arg;
+    int index;
+} pool_task_t;
+
+// Per-thread task deque: the owner pops the newest task, thieves take the oldest one
+typedef struct {
+    pthread_mutex_t lock;
+    pool_task_t *tasks;       // Ring buffer of queued tasks
+    int capacity;
+    int head;                 // Oldest task (steal end)
+    int count;
+} pool_deque_t;
+
+struct thread_pool {
+    int size;                 // Number of deques: worker threads + the submitting thread (deque 0)
+    pool_deque_t *deques;
+    pthread_t *threads;
+    int *worker_ids;
+    pthread_mutex_t lock;     // Guards sleeping workers and completion waits
+    pthread_cond_t work_ready;
+    pthread_cond_t work_done;
+    atomic_int queued;        // Tasks sitting in deques
+    atomic_int unfinished;    // Tasks submitted but not completed
+    bool stopping;
+};
+
+static thread_pool_t *par_pool = NULL;               // Shared pool used by the parallel kernels
+static int par_thread_count = 1;                     // Threads the parallel kernels may use
+static size_t par_threshold = PAR_DEFAULT_THRESHOLD; // Serial cut-off in elements
+
+// Appends a task at the owner end, growing the ring if it is full
+static bool pool_push(pool_deque_t *dq, pool_task_t task) {
+    pthread_mutex_lock(&dq->lock);
+    if (dq->count == dq->capacity) {
+        int new_capacity = dq->capacity ? dq->capacity * 2 : 64;
+        pool_task_t *grown = malloc((size_t)new_capacity * sizeof(pool_task_t));
+        if (grown == NULL) {
+            pthread_mutex_unlock(&dq->lock);
+            return false;
+        }
+        for (int i = 0; i < dq->count; i++) {
+            grown[i] = dq->tasks[(dq->head + i) % dq->capacity];
+        }
+        free(dq->tasks);
+        dq->tasks = grown;
+        dq->capacity = new_capacity;
+        dq->head = 0;
+    }
+    dq->tasks[(dq->head + dq->count) % dq->capacity] = task;
+    dq->count++;
+    pthread_mutex_unlock(&dq->lock);
+    return true;
+}
+
+// Takes a task from one end of a deque (newest for the owner, oldest for a thief)
+static bool pool_pop(pool_deque_t *dq, bool steal, pool_task_t *task) {
+    bool got = false;
+    pthread_mutex_lock(&dq->lock);
+    if (dq->count > 0) {
+        if (steal) {
+            *task = dq->tasks[dq->head];
+            dq->head = (dq->head + 1) % dq->capacity;
+        } else {
+            *task = dq->tasks[(dq->head + dq->count - 1) % dq->capacity];
+        }
+        dq->count--;
+        got = true;
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return got;
+}
+
+// Finds work for thread id: its own deque first, then the others in turn
+static bool pool_take(thread_pool_t *pool, int id, pool_task_t *task) {
+    if (atomic_load(&pool->queued) == 0) {
+        return false;
+    }
+    for (int k = 0; k < pool->size; k++) {
+        if (pool_pop(&pool->deques[(id + k) % pool->size], k != 0, task)) {
+            atomic_fetch_sub(&pool->queued, 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Runs a task and wakes the submitter when it was the last one outstanding
+static void pool_run(thread_pool_t *pool, pool_task_t *task) {
+    task->fn(task->arg, task->index);
+    if (atomic_fetch_sub(&pool->unfinished, 1) == 1) {
+        pthread_mutex_lock(&pool->lock);
+        pthread_cond_broadcast(&pool->work_done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+// Worker loop: run or steal tasks, sleep when every deque is empty
+static void *pool_worker(void *arg) {
+    int id = *(int *)arg;
+    thread_pool_t *pool = par_pool;
+    pool_task_t task;
+
+    for (;;) {
+        if (pool_take(pool, id, &task)) {
+            pool_run(pool, &task);
+            continue;
+        }
+        pthread_mutex_lock(&pool->lock);
+        while (!pool->stopping && atomic_load(&pool->queued) == 0) {
+            pthread_cond_wait(&pool->work_ready, &pool->lock);
+        }
+        bool done = pool->stopping && atomic_load(&pool->queued) == 0;
+        pthread_mutex_unlock(&pool->lock);
+        if (done) {
+            return NULL;
+        }
+    }
+}
+
+// Stops and frees a pool
+static void pool_destroy(thread_pool_t *pool) {
+    if (pool == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 1; i < pool->size; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    for (int i = 0; i < pool->size; i++) {
+        pthread_mutex_destroy(&pool->deques[i].lock);
+        free(pool->deques[i].tasks);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_cond_destroy(&pool->work_done);
+    free(pool->deques);
+    free(pool->threads);
+    free(pool->worker_ids);
+    free(pool);
+}
+
+// Creates a pool of threads - 1 workers; the calling thread is the remaining one
+static thread_pool_t *pool_create(int threads) {
+    thread_pool_t *pool = calloc(1, sizeof(thread_pool_t));
+    if (pool == NULL) {
+        return NULL;
+    }
+    pool->size = threads;
+    pool->deques = calloc((size_t)threads, sizeof(pool_deque_t));
+    pool->threads = calloc((size_t)threads, sizeof(pthread_t));
+    pool->worker_ids = calloc((size_t)threads, sizeof(int));
+    if (pool->deques == NULL || pool->threads == NULL || pool->worker_ids == NULL) {
+        free(pool->deques);
+        free(pool->threads);
+        free(pool->worker_ids);
+        free(pool);
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->work_done, NULL);
+    atomic_init(&pool->queued, 0);
+    atomic_init(&pool->unfinished, 0);
+    for (int i = 0; i < threads; i++) {
+        pthread_mutex_init(&pool->deques[i].lock, NULL);
+        pool->worker_ids[i] = i;
+    }
+
+    par_pool = pool;    // Workers pick the pool up from the shared pointer
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&pool->threads[i], NULL, pool_worker, &pool->worker_ids[i]) != 0) {
+            pool->size = i;    // Runs with the workers that did start
+            break;
+        }
+    }
+    return pool;
+}
+
+// Sets the number of threads the parallel kernels use (0 = all online CPUs)
+void par_set_threads(int threads) {
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = (online > 0) ? (int)online : 1;
+    }
+    if (par_pool != NULL && par_pool->size == threads) {
+        return;
+    }
+    pool_destroy(par_pool);
+    par_pool = NULL;
+    par_thread_count = threads;
+    if (threads > 1 && pool_create(threads) == NULL) {
+        printf("[ERROR] Unable to start a pool of %d threads. Running serially.\n", threads);
+        par_thread_count = 1;
+    }
+}
+
+// Sets the input size (in elements) below which the parallel kernels stay serial
+void par_set_threshold(size_t elements) {
+    par_threshold = elements;
+}
+
+// True when an input of this many elements should be split across the pool
+static bool par_worth_it(size_t elements) {
+    return par_pool != NULL && par_thread_count > 1 && elements >= par_threshold;
+}
+
+// Runs fn(arg, 0 .. count - 1) on the pool and returns once every index has finished
+void par_for(int count, void (*fn)(void *arg, int index), void *arg) {
+    if (par_pool == NULL || count <= 1) {
+        for (int i = 0; i < count; i++) {
+            fn(arg, i);
+        }
+        return;
+    }
+
+    // Contiguous index blocks per deque keep neighbouring tasks on one thread until stolen
+    thread_pool_t *pool = par_pool;
+    atomic_fetch_add(&pool->unfinished, count);
+    int per_deque = (count + pool->size - 1) / pool->size;
+    for (int i = 0; i < count; i++) {
+        pool_task_t task = {fn, arg, i};
+        if (!pool_push(&pool->deques[i / per_deque], task)) {
+            pool_run(pool, &task);    // Out of memory for the queue: run it here
+            continue;
+        }
+        atomic_fetch_add(&pool->queued, 1);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->lock);
+
+    // The submitting thread works as deque 0 until nothing is left to take, then waits
+    pool_task_t task;
+    while (pool_take(pool, 0, &task)) {
+        pool_run(pool, &task);
+    }
+    pthread_mutex_lock(&pool->lock);
+    while (atomic_load(&pool->unfinished) > 0) {
+        pthread_cond_wait(&pool->work_done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// ---------------------- Parallel Kernels ---------------------- //
+
+// Shared arguments of a chunked memcpy
+typedef struct {
+    char *dst;
+    const char *src;
+    size_t bytes;
+    int chunks;
+} par_copy_args_t;
+
+// Copies chunk index of a par_memcpy
+static void par_copy_chunk(void *arg, int index) {
+    par_copy_args_t *a = arg;
+    size_t chunks = (size_t)a->chunks;
+    size_t chunk = ((a->bytes + chunks - 1) / chunks + 63) & ~(size_t)63; // Ceiling, so the chunks cover every byte
+    size_t begin = (size_t)index * chunk;
+    if (begin < a->bytes) {
+        size_t len = (begin + chunk < a->bytes) ? chunk : a->bytes - begin;
+        memcpy(a->dst + begin, a->src + begin, len);
+    }
+}
+
+// memcpy split across the pool for large buffers
+void par_memcpy(void *dst, const void *src, size_t bytes) {
+    if (!par_worth_it(bytes / sizeof(int))) {
+        memcpy(dst, src, bytes);
+        return;
+    }
+    par_copy_args_t args = {dst, src, bytes, par_thread_count * PAR_TASKS_PER_THREAD};
+    par_for(args.chunks, par_copy_chunk, &args);
+}
+
+// memmove that goes parallel when source and destination do not overlap
+void par_memmove(void *dst, const void *src, size_t bytes) {
+    const char *d = dst, *s = src;
+    if (d + bytes <= s || s + bytes <= d) {
+        par_memcpy(dst, src, bytes);
+    } else {
+        memmove(dst, src, bytes);
+    }
+}
+
+// Shared arguments of a transpose split into row bands
+typedef struct {
+    int rows, cols;
+    const int *mat;
+    int *out;
+} par_transpose_args_t;
+
+// Transposes one TRANSPOSE_TILE-row band
+static void par_transpose_band(void *arg, int index) {
+    par_transpose_args_t *a = arg;
+    int r0 = index * TRANSPOSE_TILE;
+    int band = (r0 + TRANSPOSE_TILE < a->rows) ? TRANSPOSE_TILE : a->rows - r0;
+    transpose_strided(band, a->cols, a->mat + (size_t)r0 * a->cols, a->cols, a->out + r0, a->rows);
+}
+
+// Tiled transpose split by tile rows across the pool
+void transpose_parallel(int nRows, int nCols, const int *mat, int *mat_transp) {
+    if (!par_worth_it((size_t)nRows * nCols)) {
+        transpose_blocked(nRows, nCols, mat, mat_transp);
+        return;
+    }
+    par_transpose_args_t args = {nRows, nCols, mat, mat_transp};
+    par_for((nRows + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE, par_transpose_band, &args);
+}
+
+// Shared arguments of a row-band view copy
+typedef struct {
+    const int_view_t *view;
+    int *out;
+    int band;
+} par_view_args_t;
+
+// Materializes one band of rows of a view
+static void par_view_band(void *arg, int index) {
+    par_view_args_t *a = arg;
+    int r0 = index * a->band;
+    int rows = (r0 + a->band < a->view->shape[0]) ? a->band : a->view->shape[0] - r0;
+    int_view_t part = *a->view;
+    part.shape[0] = rows;
+    part.offset += r0 * a->view->strides[0];
+    view_materialize(&part, ORDER_ROW_MAJOR, a->out + (size_t)r0 * a->view->shape[1]);
+}
+
+// view_materialize split into row bands across the pool
+void view_materialize_parallel(const int_view_t *view, view_order_t order, int out[]) {
+    if (!par_worth_it(view_size(view))) {
+        view_materialize(view, order, out);
+        return;
+    }
+    if (view->rank == 1 || view_is_contiguous(view, order)) {
+        if (view_is_contiguous(view, order)) {
+            par_memcpy(out, view->base + view->offset, view_size(view) * sizeof(int));
+        } else {
+            view_materialize(view, order, out);
+        }
+        return;
+    }
+    if (order == ORDER_COL_MAJOR) {
+        int_view_t flipped = view_transpose(view);
+        view_materialize_parallel(&flipped, ORDER_ROW_MAJOR, out);
+        return;
+    }
+
+    int tasks = par_thread_count * PAR_TASKS_PER_THREAD;
+    int band = (view->shape[0] + tasks - 1) / tasks;
+    band = (band + 7) & ~7;    // Keeps the 8x8 kernels on full blocks
+    par_view_args_t args = {view, out, band};
+    par_for((view->shape[0] + band - 1) / band, par_view_band, &args);
+}
+
+// Shared state of the partitioned duplicate scan
+typedef struct {
+    const int *arr;
+    int length;
+    int chunks, chunk_len;
+    int partitions, part_bits;
+    int *offsets;             // chunks x partitions: counts, then scatter cursors
+    int *part_start;          // partitions + 1 boundaries into values/indices
+    int *values, *indices;    // Input regrouped by partition, index order kept inside each
+    dup_report_t *partials;
+    atomic_bool failed;       // Set by any partition scan that ran out of memory
+} par_dup_args_t;
+
+// Partition of a value (uses different bits than the hash table inside dup_scan_hash)
+static inline int par_dup_partition(int value, int bits) {
+    return (int)(((unsigned int)value * 0x9E3779B1u) >> (32 - bits));
+}
+
+// Phase 1: per-chunk partition histogram
+static void par_dup_count(void *arg, int index) {
+    par_dup_args_t *a = arg;
+    int *count = &a->offsets[(size_t)index * a->partitions];
+    int begin = index * a->chunk_len;
+    int end = (begin + a->chunk_len < a->length) ? begin + a->chunk_len : a->length;
+    for (int i = begin; i < end; i++) {
+        count[par_dup_partition(a->arr[i], a->part_bits)]++;
+    }
+}
+
+// Phase 2: scatter each chunk into its slots of every partition
+static void par_dup_scatter(void *arg, int index) {
+    par_dup_args_t *a = arg;
+    int *cursor = &a->offsets[(size_t)index * a->partitions];
+    int begin = index * a->chunk_len;
+    int end = (begin + a->chunk_len < a->length) ? begin + a->chunk_len : a->length;
+    for (int i = begin; i < end; i++) {
+        int slot = cursor[par_dup_partition(a->arr[i], a->part_bits)]++;
+        a->values[slot] = a->arr[i];
+        a->indices[slot] = i;
+    }
+}
+
+// Phase 3: hash scan of one partition
+static void par_dup_scan(void *arg, int index) {
+    par_dup_args_t *a = arg;
+    dup_report_t *r = &a->partials[index];
+    r->found = false;
+    r->first_i = r->first_j = -1;
+    r->duplicate_count = 0;
+    int begin = a->part_start[index];
+    if (!dup_scan_hash(&a->values[begin], &a->indices[begin], a->part_start[index + 1] - begin, r)) {
+        atomic_store(&a->failed, true);
+    }
+}
+
+// Duplicate scan using partitioned hashing on the pool, then a merge of the partition results
+bool find_duplicates_parallel(const int arr[], int length, dup_report_t *report) {
+    if (!par_worth_it((size_t)length)) {
+        return find_duplicates(arr, length, DUP_AUTO, report);
+    }
+
+    par_dup_args_t a = {0};
+    a.arr = arr;
+    a.length = length;
+    atomic_init(&a.failed, false);
+    a.chunks = par_thread_count * PAR_TASKS_PER_THREAD;
+    a.chunk_len = (length + a.chunks - 1) / a.chunks;
+    a.part_bits = 1;
+    while ((1 << a.part_bits) < a.chunks && a.part_bits < 8) {
+        a.part_bits++;
+    }
+    a.partitions = 1 << a.part_bits;
+    a.offsets = calloc((size_t)a.chunks * a.partitions, sizeof(int));
+    a.part_start = malloc(((size_t)a.partitions + 1) * sizeof(int));
+    a.values = malloc((size_t)length * sizeof(int));
+    a.indices = malloc((size_t)length * sizeof(int));
+    a.partials = malloc((size_t)a.partitions * sizeof(dup_report_t));
+
+    bool ok = a.offsets && a.part_start && a.values && a.indices && a.partials;
+    if (ok) {
+        par_for(a.chunks, par_dup_count, &a);
+
+        // Partition-major prefix sum: chunk c of partition p lands after chunks 0 .. c-1 of p
+        int running = 0;
+        for (int p = 0; p < a.partitions; p++) {
+            a.part_start[p] = running;
+            for (int c = 0; c < a.chunks; c++) {
+                int n = a.offsets[(size_t)c * a.partitions + p];
+                a.offsets[(size_t)c * a.partitions + p] = running;
+                running += n;
+            }
+        }
+        a.part_start[a.partitions] = running;
+
+        par_for(a.chunks, par_dup_scatter, &a);
+        par_for(a.partitions, par_dup_scan, &a);
+        ok = !atomic_load(&a.failed);
+    }
+
+    if (ok) {
+        report->found = false;
+        report->first_i = report->first_j = -1;
+        report->duplicate_count = 0;
+        report->strategy = DUP_HASH;
+        for (int p = 0; p < a.partitions; p++) {
+            report->duplicate_count += a.partials[p].duplicate_count;
+            if (a.partials[p].found) {
+                dup_note_pair(report, a.partials[p].first_i, a.partials[p].first_j);
+            }
+        }
+    }
+
+    free(a.offsets);
+    free(a.part_start);
+    free(a.values);
+    free(a.indices);
+    free(a.partials);
+    return ok ? true : find_duplicates(arr, length, DUP_AUTO, report);
+}
+
+// ---------------------- Buffered Output ---------------------- //
+
+#define OUT_DEFAULT_CAPACITY (1 << 20)   // 1 MB buffer, flushed with write(2)
+
+// "00" "01" ... "99": two digits per table lookup
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Prepares a writer on fd with the printArray layout: "%d " per element, newline per row
+bool out_init(out_buffer_t *out, int fd, size_t capacity) {
+    if (capacity < 64) {
+        capacity = 64;
+    }
+    out->buf = malloc(capacity);
+    if (out->buf == NULL) {
+        printf("[ERROR] Unable to allocate a %zu-byte output buffer.\n", capacity);
+        return false;
+    }
+    out->fd = fd;
+    out->capacity = capacity;
+    out->used = 0;
+    out->failed = false;
+    out_set_format(out, " ", true, "\n");
+    return true;
+}
+
+// Sets the element separator (after every element when trailing, else only between) and the row delimiter
+void out_set_format(out_buffer_t *out, const char *separator, bool trailing, const char *row_end) {
+    out->separator = separator;
+    out->sep_len = strlen(separator);
+    out->trailing = trailing;
+    out->row_end = row_end;
+    out->row_end_len = strlen(row_end);
+}
+
+// Hands the buffered bytes to the kernel, retrying short and interrupted writes
+bool out_flush(out_buffer_t *out) {
+    size_t done = 0;
+    while (done < out->used) {
+        ssize_t n = write(out->fd, out->buf + done, out->used - done);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            out->failed = true;
+            break;
+        }
+        done += (size_t)n;
+    }
+    out->used = 0;
+    return !out->failed;
+}
+
+// Flushes and releases the buffer
+void out_free(out_buffer_t *out) {
+    out_flush(out);
+    free(out->buf);
+    out->buf = NULL;
+    out->capacity = 0;
+}
+
+// Makes room for at least bytes more bytes
+static inline void out_reserve(out_buffer_t *out, size_t bytes) {
+    if (out->capacity - out->used < bytes) {
+        out_flush(out);
+    }
+}
+
+// Appends raw bytes, going straight to write(2) when they do not fit the buffer
+void out_write_bytes(out_buffer_t *out, const void *data, size_t bytes) {
+    if (bytes > out->capacity - out->used) {
+        out_flush(out);
+        if (bytes >= out->capacity) {
+            size_t saved = out->used;
+            char *saved_buf = out->buf;
+            out->buf = (char *)data;
+            out->used = bytes;
+            out_flush(out);
+            out->buf = saved_buf;
+            out->used = saved;
+            return;
+        }
+    }
+    memcpy(out->buf + out->used, data, bytes);
+    out->used += bytes;
+}
+
+// Number of decimal digits in v
+static inline size_t count_digits(unsigned int v) {
+    size_t digits = 1;
+    while (v >= 10000) {
+        v /= 10000;
+        digits += 4;
+    }
+    return digits + (v >= 10) + (v >= 100) + (v >= 1000);
+}
+
+// Formats value in decimal at dst and returns the number of characters (at most 11, caller reserves)
+static inline size_t format_int(char *dst, int value) {
+    unsigned int v = (value < 0) ? 0u - (unsigned int)value : (unsigned int)value;
+    size_t sign = (value < 0);
+    size_t len = sign + count_digits(v);
+    char *p = dst + len;
+
+    // Digits are written back to front, two at a time
+    while (v >= 100) {
+        unsigned int pair = (v % 100) * 2;
+        v /= 100;
+        *--p = digit_pairs[pair + 1];
+        *--p = digit_pairs[pair];
+    }
+    if (v >= 10) {
+        *--p = digit_pairs[v * 2 + 1];
+        *--p = digit_pairs[v * 2];
+    } else {
+        *--p = (char)('0' + v);
+    }
+    if (sign) {
+        dst[0] = '-';
+    }
+    return len;
+}
+
+// Appends one integer in decimal
+void out_write_int(out_buffer_t *out, int value) {
+    out_reserve(out, 12);
+    out->used += format_int(out->buf + out->used, value);
+}
+
+// Appends one row of values with the configured separator and row delimiter
+void out_print_row(out_buffer_t *out, const int values[], int count) {
+    size_t per_value = 11 + out->sep_len;
+    for (int i = 0; i < count; i++) {
+        out_reserve(out, per_value);
+        out->used += format_int(out->buf + out->used, values[i]);
+        if (out->trailing || i + 1 < count) {
+            if (out->sep_len == 1) {
+                out->buf[out->used++] = out->separator[0];    // Common case without a memcpy call
+            } else {
+                memcpy(out->buf + out->used, out->separator, out->sep_len);
+                out->used += out->sep_len;
+            }
+        }
+    }
+    out_write_bytes(out, out->row_end, out->row_end_len);
+}
+
+// Appends a row-major matrix, one row per line
+void out_print_matrix(out_buffer_t *out, int nRows, int nCols, const int *mat) {
+    for (int i = 0; i < nRows; i++) {
+        out_print_row(out, mat + (size_t)i * nCols, nCols);
+    }
+}
+
+// Appends the values as raw native-endian 32-bit integers
+void out_dump_binary(out_buffer_t *out, const int values[], size_t count) {
+    out_write_bytes(out, values, count * sizeof(int));
+}
+
+// Shared stdout writer behind printArray and print2DArray (NULL until first use or if allocation failed)
+out_buffer_t *out_stdout(void) {
+    static out_buffer_t writer;
+    static bool ready = false;
+    if (!ready) {
+        ready = out_init(&writer, STDOUT_FILENO, OUT_DEFAULT_CAPACITY);
+        if (!ready) {
+            return NULL;
+        }
+    }
+    return &writer;
+}
+
+// ---------------------------- Benchmarks ---------------------------- //
+
+// Monotonic wall clock in seconds
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// Small xorshift generator so every run uses the same inputs
+static unsigned int bench_rand(unsigned int *state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+// Compares the shift loops against the gap buffer for positional edits at 10^3 .. 10^7 elements
+static void bench_sequence(void) {
+    printf("\n========== SEQUENCE EDIT BENCHMARK ==========\n");
+    printf("%10s %10s %14s %14s %14s\n", "elements", "edits", "shift ns/op", "gap ns/op", "gap rand ns/op");
+
+    for (int n = 1000; n <= 10000000; n *= 10) {
+        int edits = 100000000 / n;       // Keeps the O(n) shift loops within a few seconds
+        if (edits > 200000) edits = 200000;
+        if (edits < 20) edits = 20;
+
+        int *arr = malloc((size_t)n * sizeof(int));
+        int_seq_t seq;
+        if (arr == NULL || !seq_init(&seq, n)) {
+            free(arr);
+            printf("[ERROR] Benchmark allocation failed at %d elements.\n", n);
+            return;
+        }
+        for (int i = 0; i < n; i++) {
+            arr[i] = i;
+        }
+        seq_append(&seq, arr, n);
+
+        // Shift loops: one insert and one remove per edit at random positions
+        unsigned int rng = 12345;
+        double start = bench_now();
+        for (int e = 0; e < edits; e++) {
+            int pos = (int)(bench_rand(&rng) % (unsigned int)n);
+            shift_insert(arr, pos, e);
+            shift_remove(arr, pos);
+        }
+        double shift_ns = (bench_now() - start) * 1e9 / (2.0 * edits);
+
+        // Gap buffer: cursor-local edits drifting by a few slots each time
+        int cursor = n / 2;
+        seq_insert(&seq, cursor, 0);     // Warm-up edit grows the buffer and parks the gap at the cursor
+        seq_remove(&seq, cursor);
+        rng = 12345;
+        start = bench_now();
+        for (int e = 0; e < edits; e++) {
+            cursor += (int)(bench_rand(&rng) % 17) - 8;
+            if (cursor < 0) cursor = 0;
+            if (cursor >= n) cursor = n - 1;
+            seq_insert(&seq, cursor, e);
+            seq_remove(&seq, cursor);
+        }
+        double gap_ns = (bench_now() - start) * 1e9 / (2.0 * edits);
+
+        // Gap buffer: scattered edits, where the gap travels half the buffer on average
+        int scattered = edits < 2000 ? edits : 2000;
+        start = bench_now();
+        for (int e = 0; e < scattered; e++) {
+            int pos = (int)(bench_rand(&rng) % (unsigned int)n);
+            seq_insert(&seq, pos, e);
+            seq_remove(&seq, pos);
+        }
+        double rand_ns = (bench_now() - start) * 1e9 / (2.0 * scattered);
+
+        printf("%10d %10d %14.1f %14.1f %14.1f\n", n, edits, shift_ns, gap_ns, rand_ns);
+        seq_free(&seq);
+        free(arr);
+    }
+}
+
+// Times one duplicate strategy on arr (best of several runs) and returns nanoseconds per element, or -1 if it did not run
+static double bench_dup_strategy(const int arr[], int n, dup_strategy_t strategy) {
+    double best = -1.0;
+    for (int run = 0; run < 5; run++) {
+        dup_report_t report;
+        double start = bench_now();
+        if (!find_duplicates(arr, n, strategy, &report) || report.strategy != strategy) {
+            return -1.0;
+        }
+        double ns = (bench_now() - start) * 1e9 / n;
+        if (best < 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+// Shows where the hash, radix, bitmap and nested-loop strategies cross over
+static void bench_duplicates(void) {
+    printf("\n========== DUPLICATE DETECTION BENCHMARK (ns/element) ==========\n");
+    printf("%10s %8s %10s %10s %10s %10s %8s\n", "elements", "values", "naive", "hash", "radix", "bitmap", "auto");
+
+    for (int n = 1000; n <= 10000000; n *= 10) {
+        int *arr = malloc((size_t)n * sizeof(int));
+        if (arr == NULL) {
+            printf("[ERROR] Benchmark allocation failed at %d elements.\n", n);
+            return;
+        }
+
+        for (int dense = 1; dense >= 0; dense--) {
+            // Distinct values so every strategy (and the nested loop) has to look at all of them
+            unsigned int rng = 2024;
+            for (int i = 0; i < n; i++) {
+                arr[i] = dense ? i : (int)((unsigned int)i * 2654435761u);
+            }
+            for (int i = n - 1; i > 0; i--) {
+                int k = (int)(bench_rand(&rng) % (unsigned int)(i + 1));
+                int t = arr[i];
+                arr[i] = arr[k];
+                arr[k] = t;
+            }
+
+            double naive = -1.0;
+            if (n <= 30000) {
+                double start = bench_now();
+                volatile bool sink = found_duplicate_naive(arr, n);
+                naive = (bench_now() - start) * 1e9 / n;
+                (void)sink;
+            }
+            double hash = bench_dup_strategy(arr, n, DUP_HASH);
+            double radix = bench_dup_strategy(arr, n, DUP_RADIX);
+            double bitmap = bench_dup_strategy(arr, n, DUP_BITMAP);
+            dup_report_t report;
+            find_duplicates(arr, n, DUP_AUTO, &report);
+            const char *picked = report.strategy == DUP_BITMAP ? "bitmap" : report.strategy == DUP_RADIX ? "radix" : "hash";
+
+            printf("%10d %8s ", n, dense ? "dense" : "wide");
+            if (naive < 0) printf("%10s ", "-"); else printf("%10.2f ", naive);
+            printf("%10.2f %10.2f ", hash, radix);
+            if (bitmap < 0) printf("%10s ", "-"); else printf("%10.2f ", bitmap);
+            printf("%8s\n", picked);
+        }
+        free(arr);
+    }
+}
+
+// Reports transpose throughput in GB/s (bytes read + written) for the naive loop and the tiled kernels
+static void bench_transpose(void) {
+    static const int shapes[][2] = {{1024, 1024}, {4096, 4096}, {4096, 2048}, {1000, 3001}};
+
+    printf("\n========== MATRIX TRANSPOSE BENCHMARK (GB/s, %s kernel) ==========\n", transpose_kernel_name());
+    printf("%12s %10s %10s %10s %10s\n", "shape", "naive", "blocked", "in-place", "mode");
+
+    for (size_t s = 0; s < sizeof(shapes) / sizeof(shapes[0]); s++) {
+        int rows = shapes[s][0], cols = shapes[s][1];
+        size_t total = (size_t)rows * cols;
+        double bytes = 2.0 * (double)total * sizeof(int);
+        int *mat = malloc(total * sizeof(int));
+        int *out = malloc(total * sizeof(int));
+        if (mat == NULL || out == NULL) {
+            free(mat);
+            free(out);
+            printf("[ERROR] Benchmark allocation failed for %dx%d.\n", rows, cols);
+            return;
+        }
+        for (size_t k = 0; k < total; k++) {
+            mat[k] = (int)k;
+        }
+        memset(out, 0, total * sizeof(int));    // Touches the output pages before timing
+
+        double start = bench_now();
+        trans_matrix_naive(rows, cols, mat, out);
+        double naive = bytes / (bench_now() - start) / 1e9;
+
+        start = bench_now();
+        transpose_blocked(rows, cols, mat, out);
+        double blocked = bytes / (bench_now() - start) / 1e9;
+
+        start = bench_now();
+        transpose_inplace(rows, cols, mat);
+        double inplace = bytes / (bench_now() - start) / 1e9;
+
+        // The in-place result must match the out-of-place one
+        if (memcmp(mat, out, total * sizeof(int)) != 0) {
+            printf("[ERROR] In-place transpose mismatch for %dx%d.\n", rows, cols);
+        }
+
+        char shape[24];
+        snprintf(shape, sizeof(shape), "%dx%d", rows, cols);
+        printf("%12s %10.2f %10.2f %10.2f %10s\n", shape, naive, blocked, inplace, rows == cols ? "square" : "cycles");
+        free(mat);
+        free(out);
+    }
+}
+
+// Times the parallel kernels at 1 .. N threads and checks them against the serial results
+static void bench_scaling(void) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_threads = (online > 0) ? (int)online : 1;
+    int rows = 4096, cols = 4096, n = 10000000;
+    size_t total = (size_t)rows * cols;
+
+    int *mat = malloc(total * sizeof(int));
+    int *out = malloc(total * sizeof(int));
+    int *ref = malloc(total * sizeof(int));
+    int *arr = malloc((size_t)n * sizeof(int));
+    int *batch = malloc((size_t)(n / 10) * sizeof(int));
+    if (mat == NULL || out == NULL || ref == NULL || arr == NULL || batch == NULL) {
+        printf("[ERROR] Benchmark allocation failed.\n");
+        free(mat); free(out); free(ref); free(arr); free(batch);
+        return;
+    }
+    for (size_t k = 0; k < total; k++) {
+        mat[k] = (int)k;
+    }
+    for (int i = 0; i < n; i++) {
+        arr[i] = (int)((unsigned int)i * 2654435761u);
+    }
+    arr[n - 1] = arr[n / 3];    // One known duplicate pair
+    for (int i = 0; i < n / 10; i++) {
+        batch[i] = -i;
+    }
+    transpose_blocked(rows, cols, mat, ref);
+    dup_report_t serial;
+    find_duplicates(arr, n, DUP_HASH, &serial);
+
+    printf("\n========== PARALLEL SCALING BENCHMARK (ms) ==========\n");
+    printf("%8s %12s %12s %12s %12s\n", "threads", "transpose", "duplicates", "reshape", "bulk edit");
+
+    for (int t = 1;; t = (t * 2 < max_threads) ? t * 2 : max_threads) {
+        par_set_threads(t);
+
+        double start = bench_now();
+        transpose_parallel(rows, cols, mat, out);
+        double transpose_ms = (bench_now() - start) * 1e3;
+        if (memcmp(out, ref, total * sizeof(int)) != 0) {
+            printf("[ERROR] Parallel transpose mismatch at %d threads.\n", t);
+        }
+
+        dup_report_t report;
+        start = bench_now();
+        find_duplicates_parallel(arr, n, &report);
+        double dup_ms = (bench_now() - start) * 1e3;
+        if (report.found != serial.found || report.first_i != serial.first_i ||
+            report.first_j != serial.first_j || report.duplicate_count != serial.duplicate_count) {
+            printf("[ERROR] Parallel duplicate report mismatch at %d threads.\n", t);
+        }
+
+        // Column-major reshape of the matrix buffer, materialized row-major
+        int_view_t flat = view_from_array(mat, (int)total), shaped;
+        double reshape_ms = 0.0;
+        if (view_reshape(&flat, rows, cols, ORDER_COL_MAJOR, &shaped)) {
+            start = bench_now();
+            view_materialize_parallel(&shaped, ORDER_ROW_MAJOR, out);
+            reshape_ms = (bench_now() - start) * 1e3;
+            if (memcmp(out, ref, total * sizeof(int)) != 0) {
+                printf("[ERROR] Parallel reshape mismatch at %d threads.\n", t);
+            }
+        }
+
+        // Bulk range insert and remove in the middle of a 10^7-element sequence
+        int_seq_t seq;
+        double edit_ms = 0.0;
+        if (seq_init(&seq, n) && seq_append(&seq, arr, n)) {
+            start = bench_now();
+            seq_insert_range(&seq, n / 2, batch, n / 10);
+            seq_remove_range(&seq, n / 2, n / 10);
+            seq_to_array(&seq, out);
+            edit_ms = (bench_now() - start) * 1e3;
+            if (memcmp(out, arr, (size_t)n * sizeof(int)) != 0) {
+                printf("[ERROR] Parallel bulk edit mismatch at %d threads.\n", t);
+            }
+        }
+        seq_free(&seq);
+
+        printf("%8d %12.2f %12.2f %12.2f %12.2f\n", t, transpose_ms, dup_ms, reshape_ms, edit_ms);
+        if (t == max_threads) {
+            break;
+        }
+    }
+
+    free(mat); free(out); free(ref); free(arr); free(batch);
+}
+
+// Compares printf-per-element output with the buffered formatter on a 10^7-element array
+static void bench_output(void) {
+    int n = 10000000;
+    int *arr = malloc((size_t)n * sizeof(int));
+    FILE *sink = fopen("/dev/null", "w");
+    out_buffer_t out;
+    if (arr == NULL || sink == NULL || !out_init(&out, fileno(sink), OUT_DEFAULT_CAPACITY)) {
+        printf("[ERROR] Benchmark setup failed.\n");
+        free(arr);
+        if (sink != NULL) fclose(sink);
+        return;
+    }
+    unsigned int rng = 7;
+    for (int i = 0; i < n; i++) {
+        arr[i] = (int)bench_rand(&rng) >> (i % 24);    // Mix of short and long, positive and negative values
+    }
+
+    // Spot-checks the formatter against printf on the first values and the extremes
+    char expect[32], got[32];
+    int probes[] = {0, -1, 9, 10, 99, 100, -100, 2147483647, -2147483647 - 1, arr[0], arr[1], arr[2]};
+    for (size_t p = 0; p < sizeof(probes) / sizeof(probes[0]); p++) {
+        snprintf(expect, sizeof(expect), "%d", probes[p]);
+        got[format_int(got, probes[p])] = '\0';
+        if (strcmp(expect, got) != 0) {
+            printf("[ERROR] Formatter mismatch: %s vs %s\n", got, expect);
+        }
+    }
+
+    printf("\n========== OUTPUT BENCHMARK (10^7 elements to /dev/null) ==========\n");
+
+    double start = bench_now();
+    for (int i = 0; i < n; i++) {
+        fprintf(sink, "%d ", arr[i]);
+    }
+    fprintf(sink, "\n");
+    fflush(sink);
+    double stdio_s = bench_now() - start;
+
+    start = bench_now();
+    out_print_row(&out, arr, n);
+    out_flush(&out);
+    double text_s = bench_now() - start;
+
+    out_set_format(&out, ",", false, "\n");
+    start = bench_now();
+    out_print_matrix(&out, n / 1000, 1000, arr);
+    out_flush(&out);
+    double csv_s = bench_now() - start;
+
+    start = bench_now();
+    out_dump_binary(&out, arr, (size_t)n);
+    out_flush(&out);
+    double binary_s = bench_now() - start;
+
+    printf("%-26s %10.1f ms\n", "printf(\"%d \") per element", stdio_s * 1e3);
+    printf("%-26s %10.1f ms  (%.1fx)\n", "buffered text", text_s * 1e3, stdio_s / text_s);
+    printf("%-26s %10.1f ms  (%.1fx)\n", "buffered CSV rows", csv_s * 1e3, stdio_s / csv_s);
+    printf("%-26s %10.1f ms\n", "binary dump", binary_s * 1e3);
+
+    out_free(&out);
+    fclose(sink);
+    free(arr);
+}
+
+// Runs the benchmark named on the command line (or all of them)
+int run_benchmarks(const char *name) {
+    bool all = (name == NULL);
+    bool ran = false;
+
+    if (all || strcmp(name, "seq") == 0) {
+        bench_sequence();
+        ran = true;
+    }
+    if (all || strcmp(name, "dup") == 0) {
+        bench_duplicates();
+        ran = true;
+    }
+    if (all || strcmp(name, "transpose") == 0) {
+        bench_transpose();
+        ran = true;
+    }
+    if (all || strcmp(name, "scaling") == 0) {
+        bench_scaling();
+        ran = true;
+    }
+    if (all || strcmp(name, "output") == 0) {
+        bench_output();
+        ran = true;
+    }
+
+    if (!ran) {
+        printf("[ERROR] Unknown benchmark: %s\n", name);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+// Array toolkit: growable sequences, duplicate detection, transposes, strided views, parallel
+// kernels and buffered output. The demo program in main.c is built on top of it.
+#ifndef ARRAY_TOOLKIT_H
+#define ARRAY_TOOLKIT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Growable int sequence backed by a gap buffer: edits near the gap are amortized O(1)
+typedef struct {
+    int *data;        // Backing storage holding elements before and after the gap
+    int capacity;     // Total number of slots in the backing storage
+    int gap_start;    // First free slot of the gap
+    int gap_end;      // One past the last free slot of the gap
+} int_seq_t;
+
+// Strategies the duplicate detection engine can run
+typedef enum {
+    DUP_AUTO,         // Picks one of the strategies below from the input size and value range
+    DUP_HASH,         // Open-addressing hash set, general input
+    DUP_RADIX,        // Radix sort of (value, index) pairs plus an adjacent compare, large arrays
+    DUP_BITMAP        // Bitmap over [min, max], dense small-range values
+} dup_strategy_t;
+
+// Result of a duplicate scan
+typedef struct {
+    bool found;               // True if any value occurs more than once
+    int first_i, first_j;     // First duplicate pair in nested-loop order (first_i < first_j), -1 if none
+    int duplicate_count;      // Number of elements repeating an earlier value (length - distinct values)
+    dup_strategy_t strategy;  // Strategy that actually ran
+} dup_report_t;
+
+// Element order used when a view is built over, or copied into, a flat buffer
+typedef enum {
+    ORDER_ROW_MAJOR,  // Consecutive elements of a row are adjacent
+    ORDER_COL_MAJOR   // Consecutive elements of a column are adjacent
+} view_order_t;
+
+// Strided, non-owning view over an int buffer: reshape, transpose and slicing only touch this metadata
+typedef struct {
+    const int *base;          // Underlying buffer (not owned)
+    int rank;                 // 1 for a flat array, 2 for a matrix
+    int shape[2];             // Extent of each axis
+    ptrdiff_t strides[2];     // Distance in elements between neighbours along each axis
+    ptrdiff_t offset;         // Element index of view position (0, 0) inside base
+} int_view_t;
+
+// Buffered writer for bulk integer output, flushed with write(2)
+typedef struct {
+    int fd;                   // Destination file descriptor
+    char *buf;                // Reusable output buffer
+    size_t capacity;          // Size of buf in bytes
+    size_t used;              // Bytes waiting to be written
+    const char *separator;    // Text placed between (or after) elements
+    size_t sep_len;
+    bool trailing;            // True: separator after every element, false: only between elements
+    const char *row_end;      // Text closing every row
+    size_t row_end_len;
+    bool failed;              // Set once a write(2) fails
+} out_buffer_t;
+
+// Work-stealing thread pool shared by the parallel kernels
+typedef struct thread_pool thread_pool_t;
+
+// Function prototypes
+bool isValid(const int arr[], int length, int pos);                                                   // Validates the position in an array
+void remove_element(int arr[], int length, int pos);                                                  // Removes an element from an array
+void insert_element(int arr[], int length, int pos, int value);                                       // Inserts an element into the array
+void shift_remove(int arr[], int pos);                                                                // Shift loop behind remove_element
+void shift_insert(int arr[], int pos, int value);                                                     // Shift loop behind insert_element
+void reshape(const int arr[], int length, int nRows, int nCols, int arr2d[nRows][nCols]);             // Reshapes the array
+void trans_matrix(int nRows, int nCols, const int mat[nRows][nCols], int mat_transp[nCols][nRows]);   // Transposes the matrix
+bool found_duplicate(const int arr[], int length);                                                    // Checks for duplicates within an array
+bool found_duplicate_naive(const int arr[], int length);                                              // Nested-loop duplicate check
+bool find_duplicates(const int arr[], int length, dup_strategy_t strategy, dup_report_t *report);     // Duplicate engine with first pair and count
+void printArray(const int arr[], int length);                                                         // Prints a 1D array
+void print2DArray(int nRows, int nCols, const int arr2d[nRows][nCols]);                               // Prints a 2D array
+void trans_matrix_naive(int nRows, int nCols, const int *mat, int *mat_transp);                       // Row-by-row transpose loop
+void transpose_blocked(int nRows, int nCols, const int *mat, int *mat_transp);                        // Tiled transpose with SIMD 8x8 kernels
+void transpose_strided(int nRows, int nCols, const int *src, int src_stride, int *dst, int dst_stride); // Tiled transpose between strided blocks
+void transpose_square_inplace(int n, int *mat);                                                       // In-place transpose of a square matrix
+bool transpose_inplace(int nRows, int nCols, int *mat);                                               // In-place cycle-following transpose
+const char *transpose_kernel_name(void);                                                              // Name of the 8x8 micro-kernel in use
+
+int_view_t view_from_array(const int arr[], int length);                                              // 1D view over a flat array
+int_view_t view_from_matrix(const int mat[], int nRows, int nCols, view_order_t order);               // 2D view over a contiguous matrix
+size_t view_size(const int_view_t *view);                                                             // Number of elements in a view
+int view_at(const int_view_t *view, int row, int col);                                                // Reads one element through a view
+bool view_is_contiguous(const int_view_t *view, view_order_t order);                                  // Checks for a memcpy-able layout
+bool view_reshape(const int_view_t *src, int nRows, int nCols, view_order_t order, int_view_t *out);   // O(1) reshape
+int_view_t view_transpose(const int_view_t *src);                                                     // O(1) transpose
+bool view_slice(const int_view_t *src, int row0, int nRows, int col0, int nCols, int_view_t *out);    // O(1) sub-matrix
+void view_materialize(const int_view_t *view, view_order_t order, int out[]);                         // Copies a view into a flat buffer
+
+bool seq_init(int_seq_t *seq, int capacity);                                                          // Allocates an empty sequence
+void seq_free(int_seq_t *seq);                                                                        // Releases the sequence storage
+int seq_length(const int_seq_t *seq);                                                                 // Number of stored elements
+int seq_get(const int_seq_t *seq, int pos);                                                           // Reads the element at a position
+void seq_set(int_seq_t *seq, int pos, int value);                                                     // Overwrites the element at a position
+bool seq_insert(int_seq_t *seq, int pos, int value);                                                  // Inserts one element before a position
+bool seq_remove(int_seq_t *seq, int pos);                                                             // Removes one element at a position
+bool seq_insert_range(int_seq_t *seq, int pos, const int values[], int count);                        // Inserts a whole range before a position
+bool seq_remove_range(int_seq_t *seq, int pos, int count);                                            // Removes a whole range starting at a position
+bool seq_append(int_seq_t *seq, const int values[], int count);                                       // Appends a range at the end
+void seq_to_array(const int_seq_t *seq, int out[]);                                                   // Copies the sequence into a flat array
+
+void par_set_threads(int threads);                                                                    // Thread count of the shared pool
+void par_set_threshold(size_t elements);                                                              // Size below which kernels stay serial
+void par_for(int count, void (*fn)(void *arg, int index), void *arg);                                 // Runs fn over 0..count-1 on the pool
+void par_memcpy(void *dst, const void *src, size_t bytes);                                            // Parallel bulk copy
+void par_memmove(void *dst, const void *src, size_t bytes);                                           // Parallel bulk move when not overlapping
+void transpose_parallel(int nRows, int nCols, const int *mat, int *mat_transp);                       // Transpose split by tile rows
+void view_materialize_parallel(const int_view_t *view, view_order_t order, int out[]);                // View copy split into row bands
+bool find_duplicates_parallel(const int arr[], int length, dup_report_t *report);                     // Partitioned-hash duplicate scan
+
+bool out_init(out_buffer_t *out, int fd, size_t capacity);                                            // Prepares a buffered writer on fd
+void out_set_format(out_buffer_t *out, const char *separator, bool trailing, const char *row_end);     // Separator and row delimiter
+bool out_flush(out_buffer_t *out);                                                                    // Writes the buffered bytes
+void out_free(out_buffer_t *out);                                                                     // Flushes and frees the writer
+void out_write_bytes(out_buffer_t *out, const void *data, size_t bytes);                              // Appends raw bytes
+void out_write_int(out_buffer_t *out, int value);                                                     // Appends one decimal integer
+void out_print_row(out_buffer_t *out, const int values[], int count);                                 // Appends one formatted row
+void out_print_matrix(out_buffer_t *out, int nRows, int nCols, const int *mat);                       // Appends a formatted matrix
+void out_dump_binary(out_buffer_t *out, const int values[], size_t count);                            // Appends raw 32-bit integers
+out_buffer_t *out_stdout(void);                                                                       // Shared writer on standard output
+
+int run_benchmarks(const char *name);                                                                 // Runs one benchmark, or all of them for NULL
+
+#endif
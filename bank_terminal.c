@@ -0,0 +1,2104 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <math.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <sched.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#include "bank_terminal.h"
+
+// Retry policy used for every new ledger (set from the command line)
+retry_policy_t retry_policy = {RETRY_ON_DEPOSIT, DEFAULT_MAX_RETRIES};
+
+// Log delivery used by the terminals (set from the command line)
+log_policy_t log_policy = LOG_BLOCK;
+
+// Per-phase counters for the processing thread; NULL (the default) turns every hook into one predicted branch
+static phase_stats_t *phase_stats = NULL;
+
+// --- TRANSACTION PROCESSING --- //
+void execute_transactions(const int txn_list[], int txn_count) {
+    ledger_t ledger;                    // Balance, totals and pending transactions
+    log_writer_t log;                   // Buffered transaction log on stdout
+    if (!ledger_init(&ledger) || !log_writer_init(&log, STDOUT_FILENO)) {
+        printf("[CRITICAL] Unable to allocate the transaction ledger.\n");
+        ledger_free(&ledger);
+        return;
+    }
+
+    printf("\n========== TRANSACTION LOG ==========\n");
+    printf("[INFO] Account Balance Initialized: %lld AED\n", ledger.balance);
+    fflush(stdout); // Log text goes out through write(2), after everything printed so far
+    log_writer_start_async(&log, log_policy);
+
+    // Iterates through all the transactions
+    apply_batch(&ledger, txn_list, txn_count, &log);
+    ledger_finish(&ledger, &log);
+    log_writer_free(&log);
+
+    report_ledger(&ledger);
+    ledger_free(&ledger);
+}
+
+// --- LEDGER SETUP --- //
+bool ledger_init(ledger_t *ledger) {
+    memset(ledger, 0, sizeof(*ledger));
+    ledger->balance = BASE_BALANCE;     // Initializes the user balance
+    ledger->policy = retry_policy;
+    pending_init(&ledger->pending);
+    pending_init(&ledger->abandoned);
+    return true;
+}
+
+void ledger_free(ledger_t *ledger) {
+    pending_free(&ledger->pending);
+    pending_free(&ledger->abandoned);
+}
+
+// Queues a declined transaction for retry (or straight for the pending report when retries are off)
+static void ledger_defer(ledger_t *ledger, long long txn_id, long long txn) {
+    pending_entry_t entry = {txn_id, txn, 0};
+    pending_queue_t *queue = (ledger->policy.mode == RETRY_NONE) ? &ledger->abandoned : &ledger->pending;
+    pending_push(queue, entry); // On allocation failure it is still counted as failed, just not listed
+}
+
+// --- RETRY PASS --- //
+// Gives every queued transaction one more try against the current balance, oldest first
+void ledger_retry(ledger_t *ledger, log_writer_t *log) {
+    size_t rounds = ledger->pending.count;
+
+    pending_entry_t entry;
+    for (size_t k = 0; k < rounds && pending_pop(&ledger->pending, &entry); k++) {
+
+        if (ledger->balance != 0 && ledger->balance + entry.amount >= 0) {
+            ledger->balance += entry.amount;
+            if (entry.amount < 0) {
+                ledger->total_withdrawals += -(long long)entry.amount;
+            } else {
+                ledger->total_deposits += entry.amount;
+            }
+            ledger->recovered_txns++;
+            if (log != NULL) {
+                log_event(log, LOG_RETRY, entry.txn_id, entry.amount, ledger->balance);
+            }
+        } else if (++entry.attempts >= ledger->policy.max_attempts) {
+            pending_push(&ledger->abandoned, entry);
+        } else {
+            pending_push(&ledger->pending, entry);
+        }
+    }
+}
+
+// Runs the end-of-input retry pass, if the policy asks for one
+void ledger_finish(ledger_t *ledger, log_writer_t *log) {
+    if (ledger->policy.mode == RETRY_AT_END && ledger->pending.count > 0) {
+        ledger_retry(ledger, log);
+    }
+}
+
+// --- INSTRUMENTATION HOOKS --- //
+// Cheapest monotonic tick source: the TSC where there is one, the monotonic clock in ns elsewhere
+static inline unsigned long long instr_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+#endif
+}
+
+// Charges the time since the previous mark to phase and returns the new mark (no-op without stats)
+static inline unsigned long long phase_mark(phase_stats_t *stats, phase_t phase, unsigned long long since, int items) {
+    if (stats == NULL) {
+        return 0;
+    }
+    unsigned long long now = instr_ticks();
+    stats->ticks[phase] += now - since;
+    stats->items[phase] += (unsigned long long)items;
+    return now;
+}
+
+// --- BATCH PROCESSING WITH LOG --- //
+// Logged loop with phase hooks. A constant NULL stats folds the hooks away entirely.
+// Like apply_quiet, exactly one of txns/records is non-NULL.
+static inline __attribute__((always_inline))
+void apply_logged(ledger_t *ledger, const int txns[], const ledger_record_t records[], int count,
+                  log_writer_t *log, phase_stats_t *stats) {
+    unsigned long long mark = (stats != NULL) ? instr_ticks() : 0;
+    for (int i = 0; i < count; i++) {
+        long long txn = (records != NULL) ? records[i].amount : txns[i];
+        long long txn_id = ++ledger->txn_seen;
+
+        // Stops processing if the account balance hits zero
+        if (ledger->balance == 0) {
+            mark = phase_mark(stats, PHASE_VALIDATE, mark, 1);
+            log_event(log, LOG_EXHAUSTED, txn_id, txn, 0);
+            ledger_defer(ledger, txn_id, txn);
+            ledger->failed_txns++;
+            mark = phase_mark(stats, PHASE_LOG, mark, 1);
+            continue;
+        }
+
+        // Processing withdrawals (negative values)
+        if (txn < 0 && ledger->balance + txn < 0) {
+            mark = phase_mark(stats, PHASE_VALIDATE, mark, 1);
+            // Insufficient balance for withdrawal
+            log_event(log, LOG_FAILED, txn_id, txn, 0);
+            ledger_defer(ledger, txn_id, txn);
+            ledger->failed_txns++;
+            mark = phase_mark(stats, PHASE_LOG, mark, 1);
+            continue;
+        }
+        mark = phase_mark(stats, PHASE_VALIDATE, mark, 1);
+
+        // Execute the deposit or withdrawal
+        ledger->balance += txn;
+        if (txn < 0) {
+            ledger->total_withdrawals += -txn;            // Track withdrawal amount
+        } else {
+            ledger->total_deposits += txn;                // Tracks the deposit amount
+        }
+        mark = phase_mark(stats, PHASE_APPLY, mark, 1);
+        log_transaction(log, txn_id, txn, ledger->balance);
+        mark = phase_mark(stats, PHASE_LOG, mark, 1);
+
+        // A deposit may cover withdrawals that were declined earlier
+        if (txn > 0 && ledger->pending.count > 0 && ledger->policy.mode == RETRY_ON_DEPOSIT) {
+            ledger_retry(ledger, log);
+            mark = phase_mark(stats, PHASE_APPLY, mark, 0);
+        }
+    }
+}
+
+void apply_batch(ledger_t *ledger, const int txns[], int count, log_writer_t *log) {
+    phase_stats_t *stats = phase_stats;
+    if (log == NULL) {
+        unsigned long long mark = (stats != NULL) ? instr_ticks() : 0;
+        apply_batch_quiet(ledger, txns, count);
+        phase_mark(stats, PHASE_APPLY, mark, count); // Summary-only batches are timed as a whole
+        return;
+    }
+    apply_logged(ledger, txns, NULL, count, log, stats);
+}
+
+// Mapped ledger records keep their full 64-bit amounts on both paths
+void apply_records(ledger_t *ledger, const ledger_record_t records[], int count, log_writer_t *log) {
+    phase_stats_t *stats = phase_stats;
+    if (log == NULL) {
+        unsigned long long mark = (stats != NULL) ? instr_ticks() : 0;
+        apply_records_quiet(ledger, records, count);
+        phase_mark(stats, PHASE_APPLY, mark, count);
+        return;
+    }
+    apply_logged(ledger, NULL, records, count, log, stats);
+}
+
+// --- BATCH PROCESSING, SUMMARY ONLY --- //
+// Shared by int batches and mapped ledger records: exactly one of txns/records is non-NULL,
+// and inlining gives each caller its own loop with the other branch folded away
+static inline __attribute__((always_inline))
+void apply_quiet(ledger_t *ledger, const int txns[], const ledger_record_t records[], int count) {
+    long long balance = ledger->balance;
+    long long deposits = 0, withdrawals = 0, failed = 0;
+    bool retry_on_deposit = (ledger->policy.mode == RETRY_ON_DEPOSIT);
+    bool retry_armed = retry_on_deposit && ledger->pending.count > 0;   // Kept in a register for the hot loop
+
+    for (int i = 0; i < count; i++) {
+        long long txn = (records != NULL) ? records[i].amount : txns[i];
+        // A transaction applies while the balance is non-zero and stays non-negative (deposits always do)
+        long long ok = (balance != 0) & (balance + txn >= 0);
+        long long applied = txn & -ok;
+        balance += applied;
+        deposits += applied & ~(applied >> 63);     // Positive part
+        withdrawals -= applied & (applied >> 63);   // Negative part, as a positive amount
+        failed += ok ^ 1;
+
+        if (!ok) {
+            ledger_defer(ledger, ledger->txn_seen + i + 1, txn); // Rare path: queue the declined transaction
+            retry_armed = retry_on_deposit;
+        } else if (retry_armed && applied > 0) {
+            // Rare path: hand the running totals to the ledger for a retry pass, then pick them up again
+            ledger->balance = balance;
+            ledger->total_deposits += deposits;
+            ledger->total_withdrawals += withdrawals;
+            deposits = withdrawals = 0;
+            ledger_retry(ledger, NULL);
+            balance = ledger->balance;
+            retry_armed = (ledger->pending.count > 0);
+        }
+    }
+
+    ledger->balance = balance;
+    ledger->total_deposits += deposits;
+    ledger->total_withdrawals += withdrawals;
+    ledger->failed_txns += failed;
+    ledger->txn_seen += count;
+}
+
+void apply_batch_quiet(ledger_t *ledger, const int txns[], int count) {
+    apply_quiet(ledger, txns, NULL, count);
+}
+
+void apply_records_quiet(ledger_t *ledger, const ledger_record_t records[], int count) {
+    apply_quiet(ledger, NULL, records, count);
+}
+
+// --- FINAL REPORT --- //
+void report_ledger(const ledger_t *ledger) {
+    // Final summary
+    printf("\n========== PROCESSING COMPLETE ==========\n");
+    printf("[INFO] Final Account Balance: %lld AED.\n", ledger->balance);
+
+    size_t remaining = ledger->pending.count + ledger->abandoned.count;
+    long long *amounts = (remaining > 0) ? malloc(remaining * sizeof(long long)) : NULL;
+    if (remaining > 0 || ledger->unlisted_txns > 0) {
+        printf("[NOTICE] Some transactions remain unprocessed.\n");
+        if (ledger->unlisted_txns > 0) {
+            printf("[PENDING] %lld transactions from before the checkpoint (amounts not recorded).\n",
+                   ledger->unlisted_txns);
+        }
+
+        // Both queues are in input order: merge them so the report lists transactions as they arrived
+        pending_cursor_t a = pending_cursor(&ledger->pending), b = pending_cursor(&ledger->abandoned);
+        const pending_entry_t *ea = pending_next(&a), *eb = pending_next(&b);
+        for (size_t k = 0; amounts != NULL && k < remaining; k++) {
+            if (ea != NULL && (eb == NULL || ea->txn_id < eb->txn_id)) {
+                amounts[k] = ea->amount;
+                ea = pending_next(&a);
+            } else {
+                amounts[k] = eb->amount;
+                eb = pending_next(&b);
+            }
+        }
+        if (amounts != NULL) {
+            display_pending(amounts, (int)remaining);
+        }
+        free(amounts);
+    } else {
+        printf("[SUCCESS] All transactions completed successfully.\n");
+    }
+
+    // Displays the transaction summary to the user
+    show_summary(ledger->total_deposits, ledger->total_withdrawals, ledger->failed_txns);
+    if (ledger->policy.mode != RETRY_NONE) {
+        printf("[DATA] Recovered on Retry  : %lld\n", ledger->recovered_txns);
+    }
+    if (phase_stats != NULL) {
+        show_phase_stats(phase_stats);
+    }
+}
+
+// --- PENDING QUEUE (CHUNKED ARENA) --- //
+void pending_init(pending_queue_t *queue) {
+    memset(queue, 0, sizeof(*queue));
+}
+
+void pending_free(pending_queue_t *queue) {
+    pending_chunk_t *lists[2] = {queue->head, queue->spare};
+    for (int l = 0; l < 2; l++) {
+        while (lists[l] != NULL) {
+            pending_chunk_t *next = lists[l]->next;
+            free(lists[l]);
+            lists[l] = next;
+        }
+    }
+    memset(queue, 0, sizeof(*queue));
+}
+
+// Appends an entry; a new chunk is linked in (never copied) when the tail chunk is full
+bool pending_push(pending_queue_t *queue, pending_entry_t entry) {
+    if (queue->tail == NULL || queue->tail_pos == PENDING_CHUNK) {
+        pending_chunk_t *chunk = queue->spare;
+        if (chunk != NULL) {
+            queue->spare = chunk->next;
+        } else if ((chunk = malloc(sizeof(pending_chunk_t))) == NULL) {
+            return false;
+        }
+        chunk->next = NULL;
+        if (queue->tail != NULL) {
+            queue->tail->next = chunk;
+        } else {
+            queue->head = chunk;
+            queue->head_pos = 0;
+        }
+        queue->tail = chunk;
+        queue->tail_pos = 0;
+    }
+    queue->tail->entries[queue->tail_pos++] = entry;
+    queue->count++;
+    return true;
+}
+
+// Read-only walk over a queue, oldest entry first
+pending_cursor_t pending_cursor(const pending_queue_t *queue) {
+    pending_cursor_t cursor = {queue->head, queue->head_pos, queue->count};
+    return cursor;
+}
+
+const pending_entry_t *pending_next(pending_cursor_t *cursor) {
+    if (cursor->remaining == 0) {
+        return NULL;
+    }
+    if (cursor->pos == PENDING_CHUNK) {
+        cursor->chunk = cursor->chunk->next;
+        cursor->pos = 0;
+    }
+    cursor->remaining--;
+    return &cursor->chunk->entries[cursor->pos++];
+}
+
+// Takes the oldest entry; emptied chunks go to the spare list
+bool pending_pop(pending_queue_t *queue, pending_entry_t *entry) {
+    if (queue->count == 0) {
+        return false;
+    }
+    *entry = queue->head->entries[queue->head_pos++];
+    queue->count--;
+
+    if (queue->head_pos == PENDING_CHUNK || queue->count == 0) {
+        pending_chunk_t *done = queue->head;
+        if (queue->count == 0) {
+            queue->head = queue->tail = NULL;    // Empty queue restarts at a fresh chunk
+        } else {
+            queue->head = done->next;
+        }
+        queue->head_pos = 0;
+        done->next = queue->spare;
+        queue->spare = done;
+    }
+    return true;
+}
+
+// --- NUMBER TOKENIZER --- //
+#define NUM_PARSE_CAP ((long long)INT_MAX + 1)   // Digits stop accumulating past this, so value cannot overflow
+
+// Closes the current number: stores it in *out if it fits in an int, else counts it as rejected; returns 0 or 1
+static inline int num_close(num_parser_t *parser, int *out) {
+    long long limit = parser->negative ? NUM_PARSE_CAP : INT_MAX;
+    int stored = 0;
+    if (parser->value <= limit) {
+        *out = (int)(parser->negative ? -parser->value : parser->value);
+        stored = 1;
+    } else {
+        parser->rejected++;
+    }
+    parser->in_number = false;
+    parser->value = 0;
+    return stored;
+}
+
+// Parses integers out of buf into out[] until max values are collected or buf ends; returns the count
+// and sets *used to the bytes consumed. A number cut off at the end of buf is completed on the next call.
+// Numbers outside the int range are skipped and counted in parser->rejected.
+int parse_numbers(num_parser_t *parser, const char *buf, size_t len, int out[], int max, size_t *used) {
+    int count = 0;
+    size_t k = 0;
+
+    // Numbers are separated by anything that is not a digit or a leading '-'
+    for (; k < len && count < max; k++) {
+        unsigned char c = (unsigned char)buf[k];
+        unsigned int digit = c - '0';
+        if (digit < 10) {
+            if (parser->value <= NUM_PARSE_CAP) {
+                parser->value = parser->value * 10 + digit;
+            }
+            parser->in_number = true;
+            continue;
+        }
+        if (parser->in_number) {
+            count += num_close(parser, &out[count]);
+        }
+        parser->negative = (c == '-');
+    }
+
+    *used = k;
+    return count;
+}
+
+// Emits the number still open at end of input, if any; returns 0 or 1
+int parse_numbers_finish(num_parser_t *parser, int out[]) {
+    if (!parser->in_number) {
+        return 0;
+    }
+    return num_close(parser, out);
+}
+
+// Reads fd to the end, handing every full batch of batch_size numbers (and the final partial one) to flush
+static int stream_numbers(int fd, int batch[], int batch_size, void (*flush)(void *ctx, int batch[], int count), void *ctx) {
+    char *input = malloc(STREAM_READ_SIZE);
+    if (input == NULL) {
+        fprintf(stderr, "[CRITICAL] Unable to allocate the read buffer.\n");
+        return 1;
+    }
+
+    num_parser_t parser = {0, false, false, 0};
+    int batch_count = 0;
+    int status = 0;
+
+    for (;;) {
+        ssize_t got = read(fd, input, STREAM_READ_SIZE);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            fprintf(stderr, "[ERROR] Read failed: %s\n", strerror(errno));
+            status = 1;
+            break;
+        }
+        if (got == 0) {
+            unsigned long long mark = (phase_stats != NULL) ? instr_ticks() : 0;
+            int parsed = parse_numbers_finish(&parser, &batch[batch_count]);
+            phase_mark(phase_stats, PHASE_PARSE, mark, parsed);
+            batch_count += parsed;
+            break;
+        }
+
+        size_t offset = 0;
+        while (offset < (size_t)got) {
+            size_t used;
+            unsigned long long mark = (phase_stats != NULL) ? instr_ticks() : 0;
+            int parsed = parse_numbers(&parser, input + offset, (size_t)got - offset,
+                                       &batch[batch_count], batch_size - batch_count, &used);
+            phase_mark(phase_stats, PHASE_PARSE, mark, parsed);
+            batch_count += parsed;
+            offset += used;
+            if (batch_count == batch_size) {
+                flush(ctx, batch, batch_count);
+                batch_count = 0;
+            }
+        }
+    }
+
+    if (batch_count > 0) {
+        flush(ctx, batch, batch_count);
+    }
+    if (parser.rejected > 0) {
+        fprintf(stderr, "[ERROR] Skipped %lld amount(s) outside %d..%d AED.\n", parser.rejected, INT_MIN, INT_MAX);
+        status = 1;
+    }
+    free(input);
+    return status;
+}
+
+// Stream context for the single-account terminal
+typedef struct {
+    ledger_t *ledger;
+    log_writer_t *log;          // NULL in quiet mode
+} single_stream_t;
+
+static void flush_single_batch(void *ctx, int batch[], int count) {
+    single_stream_t *s = ctx;
+    apply_batch(s->ledger, batch, count, s->log);
+}
+
+// --- STREAMING TRANSACTION PROCESSING --- //
+int execute_transaction_stream(int fd, bool quiet) {
+    ledger_t ledger;
+    log_writer_t log;
+    int *batch = malloc(STREAM_BATCH * sizeof(int));
+    if (batch == NULL || !ledger_init(&ledger) || !log_writer_init(&log, STDOUT_FILENO)) {
+        fprintf(stderr, "[CRITICAL] Unable to allocate the streaming buffers.\n");
+        free(batch);
+        return 1;
+    }
+
+    printf(">>[INIT] Activating Banking Terminal (streaming mode)...\n");
+    printf("[SECURE] System Timestamp: %s\n", get_time_stamp());
+    printf("\n========== TRANSACTION LOG ==========\n");
+    printf("[INFO] Account Balance Initialized: %lld AED\n", ledger.balance);
+    fflush(stdout);
+
+    if (!quiet) {
+        log_writer_start_async(&log, log_policy);
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    single_stream_t ctx = {&ledger, quiet ? NULL : &log};
+    int status = stream_numbers(fd, batch, STREAM_BATCH, flush_single_batch, &ctx);
+    ledger_finish(&ledger, ctx.log);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    log_writer_free(&log);
+
+    report_ledger(&ledger);
+    double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+    printf("[PERF] %lld transactions in %.3f s (%.1f M txn/s)\n", ledger.txn_seen, seconds,
+           seconds > 0 ? (double)ledger.txn_seen / seconds / 1e6 : 0.0);
+    printf("\n[SHUTDOWN] Banking Terminal Offline.\n");
+
+    ledger_free(&ledger);
+    free(batch);
+    return status;
+}
+
+// --- MULTI-ACCOUNT SHARDED LEDGER --- //
+
+// Spreads account ids over the 32-bit range before picking a shard or a table slot
+static inline unsigned int account_hash(int account_id) {
+    unsigned int x = (unsigned int)account_id;
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+// Shard owning an account: high hash bits scaled to the shard count
+static inline int account_shard(int account_id, int shard_count) {
+    return (int)(((unsigned long long)account_hash(account_id) * (unsigned int)shard_count) >> 32);
+}
+
+// Finds an account in its shard, opening it at BASE_BALANCE on first use (NULL if the table cannot grow)
+static account_t *shard_account(ledger_shard_t *shard, int account_id) {
+    if ((shard->account_count + 1) * 2 > shard->capacity) {
+        size_t grown_capacity = shard->capacity ? shard->capacity * 2 : 1024;
+        account_t *grown = calloc(grown_capacity, sizeof(account_t));
+        if (grown == NULL) {
+            return NULL;
+        }
+        for (size_t i = 0; i < shard->capacity; i++) {
+            if (shard->accounts[i].in_use) {
+                size_t h = account_hash(shard->accounts[i].account_id) & (grown_capacity - 1);
+                while (grown[h].in_use) {
+                    h = (h + 1) & (grown_capacity - 1);
+                }
+                grown[h] = shard->accounts[i];
+            }
+        }
+        free(shard->accounts);
+        shard->accounts = grown;
+        shard->capacity = grown_capacity;
+    }
+
+    // Low hash bits pick the slot (the shard was picked by the high bits)
+    size_t mask = shard->capacity - 1;
+    size_t h = account_hash(account_id) & mask;
+    while (shard->accounts[h].in_use && shard->accounts[h].account_id != account_id) {
+        h = (h + 1) & mask;
+    }
+    account_t *account = &shard->accounts[h];
+    if (!account->in_use) {
+        account->in_use = true;
+        account->account_id = account_id;
+        account->balance = BASE_BALANCE;
+        shard->account_count++;
+    }
+    return account;
+}
+
+// Applies the shard's inbox in arrival order, with the same rules as the single-account terminal
+static void shard_apply_inbox(ledger_shard_t *shard) {
+    for (int i = 0; i < shard->inbox_count; i++) {
+        account_t *account = shard_account(shard, shard->inbox[i].account_id);
+        long long amount = shard->inbox[i].amount;
+        if (account == NULL || account->balance == 0 || account->balance + amount < 0) {
+            shard->failed_txns++;
+            if (account != NULL) {
+                account->failed_txns++;
+            }
+            continue;
+        }
+        account->balance += amount;
+        if (amount < 0) {
+            account->total_withdrawals -= amount;
+            shard->total_withdrawals -= amount;
+        } else {
+            account->total_deposits += amount;
+            shard->total_deposits += amount;
+        }
+    }
+    shard->txn_seen += shard->inbox_count;
+    shard->inbox_count = 0;
+}
+
+// Worker thread: waits for a partitioned batch, applies its shard, reports back
+static void *shard_worker(void *arg) {
+    ledger_shard_t *shard = arg;
+    sharded_ledger_t *ledger = shard->owner;
+    for (;;) {
+        sem_wait(&shard->batch_ready);
+        if (ledger->stopping) {
+            return NULL;
+        }
+        shard_apply_inbox(shard);
+        sem_post(&ledger->batch_done);
+    }
+}
+
+// Sets up shard_count shards; shard 0 runs on the calling thread, the others on their own threads
+bool sharded_ledger_init(sharded_ledger_t *ledger, int shard_count) {
+    memset(ledger, 0, sizeof(*ledger));
+    ledger->shards = calloc((size_t)shard_count, sizeof(ledger_shard_t));
+    if (ledger->shards == NULL) {
+        return false;
+    }
+    ledger->shard_count = shard_count;
+    sem_init(&ledger->batch_done, 0, 0);
+
+    for (int i = 0; i < shard_count; i++) {
+        ledger_shard_t *shard = &ledger->shards[i];
+        shard->owner = ledger;
+        shard->inbox = malloc(STREAM_BATCH * sizeof(account_txn_t));
+        if (shard->inbox == NULL) {
+            sharded_ledger_free(ledger);
+            return false;
+        }
+        sem_init(&shard->batch_ready, 0, 0);
+        // A shard whose thread cannot start is simply applied by the caller
+        if (i > 0 && pthread_create(&shard->thread, NULL, shard_worker, shard) == 0) {
+            shard->has_thread = true;
+            ledger->worker_count++;
+        }
+    }
+    return true;
+}
+
+// Stops the shard threads and frees every account table
+void sharded_ledger_free(sharded_ledger_t *ledger) {
+    ledger->stopping = true;
+    for (int i = 0; ledger->shards != NULL && i < ledger->shard_count; i++) {
+        ledger_shard_t *shard = &ledger->shards[i];
+        if (shard->has_thread) {
+            sem_post(&shard->batch_ready);
+            pthread_join(shard->thread, NULL);
+        }
+        if (shard->inbox != NULL) {
+            sem_destroy(&shard->batch_ready);
+        }
+        free(shard->accounts);
+        free(shard->inbox);
+    }
+    if (ledger->shards != NULL) {
+        sem_destroy(&ledger->batch_done);
+    }
+    free(ledger->shards);
+    memset(ledger, 0, sizeof(*ledger));
+}
+
+// Routes each transaction to its account's shard (order kept per shard), then applies all shards in parallel
+void sharded_ledger_apply(sharded_ledger_t *ledger, const account_txn_t txns[], int count) {
+    while (count > 0) {
+        int chunk = (count < STREAM_BATCH) ? count : STREAM_BATCH;    // An inbox holds at most one batch
+        for (int i = 0; i < chunk; i++) {
+            ledger_shard_t *shard = &ledger->shards[account_shard(txns[i].account_id, ledger->shard_count)];
+            shard->inbox[shard->inbox_count++] = txns[i];
+        }
+
+        for (int i = 0; i < ledger->shard_count; i++) {
+            if (ledger->shards[i].has_thread) {
+                sem_post(&ledger->shards[i].batch_ready);
+            }
+        }
+        for (int i = 0; i < ledger->shard_count; i++) {
+            if (!ledger->shards[i].has_thread) {
+                shard_apply_inbox(&ledger->shards[i]);
+            }
+        }
+        for (int i = 0; i < ledger->worker_count; i++) {
+            sem_wait(&ledger->batch_done);
+        }
+        txns += chunk;
+        count -= chunk;
+    }
+}
+
+// Merges the per-shard totals and prints them next to show_summary
+void report_sharded_ledger(const sharded_ledger_t *ledger) {
+    long long deposits = 0, withdrawals = 0, failed = 0, seen = 0, balance = 0;
+    size_t accounts = 0;
+    for (int i = 0; i < ledger->shard_count; i++) {
+        const ledger_shard_t *shard = &ledger->shards[i];
+        deposits += shard->total_deposits;
+        withdrawals += shard->total_withdrawals;
+        failed += shard->failed_txns;
+        seen += shard->txn_seen;
+        accounts += shard->account_count;
+        for (size_t k = 0; k < shard->capacity; k++) {
+            if (shard->accounts[k].in_use) {
+                balance += shard->accounts[k].balance;
+            }
+        }
+    }
+
+    printf("\n========== PROCESSING COMPLETE ==========\n");
+    printf("[INFO] Shards                : %d\n", ledger->shard_count);
+    printf("[INFO] Accounts Tracked      : %zu\n", accounts);
+    printf("[INFO] Transactions Seen     : %lld\n", seen);
+    printf("[INFO] Combined Balance      : %lld AED\n", balance);
+    show_summary(deposits, withdrawals, failed);
+    if (phase_stats != NULL) {
+        show_phase_stats(phase_stats); // Only parsing runs on this thread; shards apply on their own
+    }
+}
+
+// Stream context for the multi-account terminal
+typedef struct {
+    sharded_ledger_t *ledger;
+    account_txn_t *pairs;
+} account_stream_t;
+
+// Turns a batch of "account amount" number pairs into tagged transactions and applies them
+static void flush_account_batch(void *ctx, int batch[], int count) {
+    account_stream_t *s = ctx;
+    int pairs = count / 2;
+    for (int i = 0; i < pairs; i++) {
+        s->pairs[i].account_id = batch[2 * i];
+        s->pairs[i].amount = batch[2 * i + 1];
+    }
+    if (count % 2 != 0) {
+        fprintf(stderr, "[ERROR] Account %d has no amount; entry ignored.\n", batch[count - 1]);
+    }
+    sharded_ledger_apply(s->ledger, s->pairs, pairs);
+}
+
+// --- MULTI-ACCOUNT STREAM PROCESSING --- //
+int execute_account_stream(int fd, int shard_count) {
+    sharded_ledger_t ledger;
+    int *batch = malloc(2 * STREAM_BATCH * sizeof(int));
+    account_txn_t *pairs = malloc(STREAM_BATCH * sizeof(account_txn_t));
+    if (batch == NULL || pairs == NULL || !sharded_ledger_init(&ledger, shard_count)) {
+        fprintf(stderr, "[CRITICAL] Unable to set up the sharded ledger.\n");
+        free(batch);
+        free(pairs);
+        return 1;
+    }
+
+    printf(">>[INIT] Activating Banking Terminal (multi-account, %d shards)...\n", shard_count);
+    printf("[SECURE] System Timestamp: %s\n", get_time_stamp());
+    fflush(stdout);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    account_stream_t ctx = {&ledger, pairs};
+    int status = stream_numbers(fd, batch, 2 * STREAM_BATCH, flush_account_batch, &ctx);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    report_sharded_ledger(&ledger);
+    double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+    printf("[PERF] Processed in %.3f s\n", seconds);
+    printf("\n[SHUTDOWN] Banking Terminal Offline.\n");
+
+    sharded_ledger_free(&ledger);
+    free(batch);
+    free(pairs);
+    return status;
+}
+
+// --- BINARY LEDGER FILE --- //
+// Maps a ledger file read-only and checks that its header, records and checkpoint table fit in it
+bool ledger_file_open(ledger_file_t *file, const char *path) {
+    memset(file, 0, sizeof(*file));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "[ERROR] Cannot open %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ledger_file_header_t)) {
+        fprintf(stderr, "[ERROR] %s is not a ledger file.\n", path);
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps the file contents reachable
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "[ERROR] Cannot map %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    madvise(map, size, MADV_SEQUENTIAL); // Replay reads front to back: let the kernel read ahead
+
+    // Each bound is checked before it is used in the next one, so a corrupt header cannot overflow them
+    const ledger_file_header_t *header = map;
+    bool valid = memcmp(header->magic, LEDGER_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->version == LEDGER_VERSION &&
+                 header->record_size == sizeof(ledger_record_t) &&
+                 header->record_count <= (size - sizeof(*header)) / sizeof(ledger_record_t) &&
+                 header->checkpoint_offset >= sizeof(*header) + header->record_count * sizeof(ledger_record_t) &&
+                 header->checkpoint_offset <= size &&
+                 header->checkpoint_offset % sizeof(int64_t) == 0 &&
+                 header->checkpoint_count <= (size - header->checkpoint_offset) / sizeof(ledger_checkpoint_t);
+    if (!valid) {
+        fprintf(stderr, "[ERROR] %s is not a ledger file or is truncated.\n", path);
+        munmap(map, size);
+        return false;
+    }
+
+    file->map = map;
+    file->map_size = size;
+    file->header = header;
+    file->records = (const ledger_record_t *)((const char *)map + sizeof(*header));
+    file->checkpoints = (const ledger_checkpoint_t *)((const char *)map + header->checkpoint_offset);
+    return true;
+}
+
+void ledger_file_close(ledger_file_t *file) {
+    if (file->map != NULL) {
+        munmap(file->map, file->map_size);
+        file->map = NULL;
+    }
+}
+
+// Latest checkpoint a ledger with this policy can resume from, or NULL. Checkpoints only hold totals,
+// so one taken with transactions still queued for retry (or under another policy) is not usable.
+const ledger_checkpoint_t *ledger_file_checkpoint(const ledger_file_t *file, const retry_policy_t *policy) {
+    const ledger_file_header_t *header = file->header;
+    if (header->retry_mode != (uint32_t)policy->mode ||
+        (policy->mode != RETRY_NONE && header->retry_max_attempts != (uint32_t)policy->max_attempts)) {
+        return NULL;
+    }
+    for (uint64_t k = header->checkpoint_count; k-- > 0;) {
+        const ledger_checkpoint_t *checkpoint = &file->checkpoints[k];
+        if (checkpoint->pending_count == 0 && checkpoint->record_index <= header->record_count) {
+            return checkpoint;
+        }
+    }
+    return NULL;
+}
+
+// Sets a fresh ledger up to replay file: from the start, or from the latest usable checkpoint when resuming
+static const ledger_checkpoint_t *ledger_start_replay(ledger_t *ledger, const ledger_file_t *file, bool resume) {
+    ledger->balance = file->header->base_balance;
+    const ledger_checkpoint_t *checkpoint = resume ? ledger_file_checkpoint(file, &ledger->policy) : NULL;
+    if (checkpoint != NULL) {
+        ledger->txn_seen = (long long)checkpoint->record_index;
+        ledger->balance = checkpoint->balance;
+        ledger->total_deposits = checkpoint->total_deposits;
+        ledger->total_withdrawals = checkpoint->total_withdrawals;
+        ledger->failed_txns = checkpoint->failed_txns;
+        ledger->recovered_txns = checkpoint->recovered_txns;
+        ledger->unlisted_txns = (long long)(checkpoint->pending_count + checkpoint->abandoned_count);
+    }
+    return checkpoint;
+}
+
+// Applies every record after ledger->txn_seen, straight from the mapping when quiet (log == NULL)
+static void replay_records(ledger_t *ledger, const ledger_file_t *file, log_writer_t *log) {
+    uint64_t total = file->header->record_count;
+    for (uint64_t next = (uint64_t)ledger->txn_seen; next < total;) {
+        int count = (total - next < STREAM_BATCH) ? (int)(total - next) : STREAM_BATCH;
+        apply_records(ledger, &file->records[next], count, log);
+        next += (uint64_t)count;
+    }
+    ledger_finish(ledger, log);
+}
+
+// --- LEDGER FILE WRITER --- //
+bool ledger_file_writer_init(ledger_file_writer_t *writer, int fd) {
+    memset(writer, 0, sizeof(*writer));
+    writer->fd = fd;
+    writer->chunk = malloc(STREAM_BATCH * sizeof(ledger_record_t));
+    if (writer->chunk == NULL || !log_writer_init(&writer->out, fd)) {
+        free(writer->chunk);
+        free(writer->out.buf);
+        return false;
+    }
+    ledger_init(&writer->ledger);
+
+    ledger_file_header_t blank;  // Placeholder, rewritten once the counts are known
+    memset(&blank, 0, sizeof(blank));
+    log_writer_append(&writer->out, (const char *)&blank, sizeof(blank));
+    return true;
+}
+
+// Snapshots the shadow ledger's totals into the checkpoint table
+static bool ledger_file_writer_checkpoint(ledger_file_writer_t *writer) {
+    if (writer->checkpoint_count == writer->checkpoint_capacity) {
+        size_t capacity = (writer->checkpoint_capacity > 0) ? writer->checkpoint_capacity * 2 : 64;
+        ledger_checkpoint_t *grown = realloc(writer->checkpoints, capacity * sizeof(ledger_checkpoint_t));
+        if (grown == NULL) {
+            return false;
+        }
+        writer->checkpoints = grown;
+        writer->checkpoint_capacity = capacity;
+    }
+    const ledger_t *ledger = &writer->ledger;
+    ledger_checkpoint_t checkpoint = {(uint64_t)ledger->txn_seen, ledger->balance, ledger->total_deposits,
+                                      ledger->total_withdrawals, ledger->failed_txns, ledger->recovered_txns,
+                                      ledger->pending.count, ledger->abandoned.count};
+    writer->checkpoints[writer->checkpoint_count++] = checkpoint;
+    return true;
+}
+
+// Applies the buffered records to the shadow ledger, checkpointing on every interval boundary
+static bool ledger_file_writer_apply(ledger_file_writer_t *writer) {
+    apply_records_quiet(&writer->ledger, writer->chunk, writer->chunk_count);
+    writer->chunk_count = 0;
+    if (writer->ledger.txn_seen % LEDGER_CHECKPOINT_INTERVAL == 0) {
+        return ledger_file_writer_checkpoint(writer);
+    }
+    return true;
+}
+
+bool ledger_file_writer_add(ledger_file_writer_t *writer, ledger_record_t record) {
+    log_writer_append(&writer->out, (const char *)&record, sizeof(record));
+    writer->chunk[writer->chunk_count++] = record;
+    if (writer->chunk_count == STREAM_BATCH) {
+        return ledger_file_writer_apply(writer);
+    }
+    return true;
+}
+
+// Writes the checkpoint table and the real header, then releases the writer; false if any write failed
+bool ledger_file_writer_finish(ledger_file_writer_t *writer) {
+    bool ok = true;
+    if (writer->chunk_count > 0) {
+        ok = ledger_file_writer_apply(writer);
+    }
+    // A checkpoint at the very end lets an unchanged file resume without replaying anything
+    uint64_t record_count = (uint64_t)writer->ledger.txn_seen;
+    if (ok && record_count > 0 && (writer->checkpoint_count == 0 ||
+                                   writer->checkpoints[writer->checkpoint_count - 1].record_index != record_count)) {
+        ok = ledger_file_writer_checkpoint(writer);
+    }
+    for (size_t k = 0; ok && k < writer->checkpoint_count; k++) {
+        log_writer_append(&writer->out, (const char *)&writer->checkpoints[k], sizeof(ledger_checkpoint_t));
+    }
+    log_writer_flush(&writer->out);
+
+    ledger_file_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, LEDGER_MAGIC, sizeof(header.magic));
+    header.version = LEDGER_VERSION;
+    header.record_size = sizeof(ledger_record_t);
+    header.record_count = record_count;
+    header.base_balance = BASE_BALANCE;
+    header.checkpoint_interval = LEDGER_CHECKPOINT_INTERVAL;
+    header.checkpoint_count = ok ? writer->checkpoint_count : 0;
+    header.checkpoint_offset = sizeof(header) + record_count * sizeof(ledger_record_t);
+    header.retry_mode = (uint32_t)writer->ledger.policy.mode;
+    header.retry_max_attempts = (uint32_t)writer->ledger.policy.max_attempts;
+    ok = ok && !writer->out.failed && pwrite(writer->fd, &header, sizeof(header), 0) == (ssize_t)sizeof(header);
+
+    log_writer_free(&writer->out);
+    ledger_free(&writer->ledger);
+    free(writer->chunk);
+    free(writer->checkpoints);
+    writer->chunk = NULL;
+    writer->checkpoints = NULL;
+    return ok;
+}
+
+// --- CSV TO LEDGER CONVERTER --- //
+// Collects the integers on one CSV line into fields[]; returns how many there were
+// (max + 1 if more, or if one does not fit in -INT64_MAX..INT64_MAX)
+static int csv_line_fields(const char *p, const char *end, long long fields[], int max) {
+    int count = 0;
+    while (p < end) {
+        bool negative = (*p == '-' && p + 1 < end && (unsigned int)(p[1] - '0') < 10);
+        p += negative;
+        if ((unsigned int)(*p - '0') >= 10) {
+            p++;
+            continue;
+        }
+        long long value = 0;
+        bool overflow = false;
+        for (; p < end && (unsigned int)(*p - '0') < 10; p++) {
+            int digit = *p - '0';
+            overflow |= (value > (INT64_MAX - digit) / 10);
+            value = overflow ? INT64_MAX : value * 10 + digit;
+        }
+        if (count == max || overflow) {
+            return max + 1;
+        }
+        fields[count++] = negative ? -value : value;
+    }
+    return count;
+}
+
+// Converts "amount", "account,amount" or "account,amount,timestamp" lines into a ledger file.
+// Lines without numbers (headers, blanks) are skipped; a missing timestamp becomes the conversion time.
+int convert_csv_ledger(const char *csv_path, const char *out_path) {
+    int in = open(csv_path, O_RDONLY);
+    struct stat st;
+    if (in < 0 || fstat(in, &st) != 0) {
+        fprintf(stderr, "[ERROR] Cannot open %s: %s\n", csv_path, strerror(errno));
+        if (in >= 0) {
+            close(in);
+        }
+        return 1;
+    }
+    size_t size = (size_t)st.st_size;
+    const char *text = (size > 0) ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, in, 0) : NULL;
+    close(in);
+    if (text == MAP_FAILED) {
+        fprintf(stderr, "[ERROR] Cannot map %s: %s\n", csv_path, strerror(errno));
+        return 1;
+    }
+    if (text != NULL) {
+        madvise((void *)text, size, MADV_SEQUENTIAL);
+    }
+
+    int out = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ledger_file_writer_t writer;
+    if (out < 0 || !ledger_file_writer_init(&writer, out)) {
+        fprintf(stderr, "[ERROR] Cannot create %s: %s\n", out_path, strerror(errno));
+        if (out >= 0) {
+            close(out);
+        }
+        if (text != NULL) {
+            munmap((void *)text, size);
+        }
+        return 1;
+    }
+
+    uint32_t now = (uint32_t)time(NULL);
+    long long line_number = 0, ignored = 0;
+    bool ok = true;
+    for (const char *p = text, *end = text + size; ok && p < end;) {
+        const char *eol = memchr(p, '\n', (size_t)(end - p));
+        if (eol == NULL) {
+            eol = end;
+        }
+        long long fields[3];
+        int count = csv_line_fields(p, eol, fields, 3);
+        p = (eol < end) ? eol + 1 : end;
+        line_number++;
+        if (count == 0) {
+            continue;
+        }
+
+        long long account = (count >= 2) ? fields[0] : 0;
+        long long amount = (count >= 2) ? fields[1] : fields[0];
+        long long stamp = (count == 3) ? fields[2] : now;
+        if (count > 3 || account < 0 || account > UINT32_MAX || stamp < 0 || stamp > UINT32_MAX) {
+            fprintf(stderr, "[ERROR] %s line %lld: expected amount, account,amount or account,amount,timestamp; entry ignored.\n",
+                    csv_path, line_number);
+            ignored++;
+            continue;
+        }
+        ledger_record_t record = {amount, (uint32_t)account, (uint32_t)stamp};
+        ok = ledger_file_writer_add(&writer, record);
+    }
+
+    long long records = writer.ledger.txn_seen + writer.chunk_count;
+    ok = ledger_file_writer_finish(&writer) && ok;
+    close(out);
+    if (text != NULL) {
+        munmap((void *)text, size);
+    }
+    if (!ok) {
+        fprintf(stderr, "[ERROR] Could not write %s.\n", out_path);
+        return 1;
+    }
+    printf("[SYS] Converted %lld transactions from %s into %s (%zu checkpoints).\n",
+           records, csv_path, out_path, writer.checkpoint_count);
+    if (ignored > 0) {
+        printf("[NOTICE] %lld lines ignored.\n", ignored);
+    }
+    return 0;
+}
+
+// --- LEDGER REPLAY --- //
+int execute_ledger_replay(const char *path, bool quiet, bool resume) {
+    ledger_file_t file;
+    ledger_t ledger;
+    log_writer_t log;
+    if (!ledger_file_open(&file, path)) {
+        return 1;
+    }
+    if (!ledger_init(&ledger) || !log_writer_init(&log, STDOUT_FILENO)) {
+        fprintf(stderr, "[CRITICAL] Unable to allocate the replay buffers.\n");
+        ledger_file_close(&file);
+        return 1;
+    }
+
+    printf(">>[INIT] Activating Banking Terminal (replay mode)...\n");
+    printf("[SECURE] System Timestamp: %s\n", get_time_stamp());
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    const ledger_checkpoint_t *checkpoint = ledger_start_replay(&ledger, &file, resume);
+    if (checkpoint != NULL) {
+        printf("[SYS] Resuming from checkpoint at transaction %lld.\n", ledger.txn_seen);
+    } else if (resume) {
+        printf("[NOTICE] No usable checkpoint for this retry policy; replaying from the start.\n");
+    }
+    long long first = ledger.txn_seen;
+
+    printf("\n========== TRANSACTION LOG ==========\n");
+    printf("[INFO] Account Balance %s: %lld AED\n", checkpoint != NULL ? "Restored" : "Initialized", ledger.balance);
+    fflush(stdout);
+    if (!quiet) {
+        log_writer_start_async(&log, log_policy);
+    }
+
+    replay_records(&ledger, &file, quiet ? NULL : &log);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    log_writer_free(&log);
+
+    report_ledger(&ledger);
+    double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+    printf("[PERF] %lld transactions replayed in %.3f s (%.1f M txn/s)\n", ledger.txn_seen - first, seconds,
+           seconds > 0 ? (double)(ledger.txn_seen - first) / seconds / 1e6 : 0.0);
+    printf("\n[SHUTDOWN] Banking Terminal Offline.\n");
+
+    ledger_free(&ledger);
+    ledger_file_close(&file);
+    return 0;
+}
+
+// Multi-account replay: every record goes to its account's shard (checkpoints cover the single-account ledger only)
+int execute_account_replay(const char *path, int shard_count) {
+    ledger_file_t file;
+    sharded_ledger_t ledger;
+    if (!ledger_file_open(&file, path)) {
+        return 1;
+    }
+    account_txn_t *pairs = malloc(STREAM_BATCH * sizeof(account_txn_t));
+    if (pairs == NULL || !sharded_ledger_init(&ledger, shard_count)) {
+        fprintf(stderr, "[CRITICAL] Unable to set up the sharded ledger.\n");
+        free(pairs);
+        ledger_file_close(&file);
+        return 1;
+    }
+
+    printf(">>[INIT] Activating Banking Terminal (multi-account replay, %d shards)...\n", shard_count);
+    printf("[SECURE] System Timestamp: %s\n", get_time_stamp());
+    fflush(stdout);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    uint64_t total = file.header->record_count;
+    for (uint64_t next = 0; next < total;) {
+        int count = (total - next < STREAM_BATCH) ? (int)(total - next) : STREAM_BATCH;
+        const ledger_record_t *records = &file.records[next];
+        for (int i = 0; i < count; i++) {
+            pairs[i].account_id = (int)records[i].account_id;
+            pairs[i].amount = records[i].amount;
+        }
+        sharded_ledger_apply(&ledger, pairs, count);
+        next += (uint64_t)count;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    report_sharded_ledger(&ledger);
+    double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+    printf("[PERF] Processed in %.3f s\n", seconds);
+    printf("\n[SHUTDOWN] Banking Terminal Offline.\n");
+
+    sharded_ledger_free(&ledger);
+    ledger_file_close(&file);
+    free(pairs);
+    return 0;
+}
+
+// --- CONCURRENT INGESTION --- //
+static inline long long monotonic_ns(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+// Wait step for a full or empty ring: spin briefly, then give the CPU to the other side
+static inline void spin_backoff(int *spins) {
+    if (*spins < 64) {
+        (*spins)++;
+    } else {
+        sched_yield();
+    }
+}
+
+bool ingest_init(ingest_t *ingest, int producer_count, ledger_t *ledger) {
+    memset(ingest, 0, sizeof(*ingest));
+    ingest->rings = aligned_alloc(64, (size_t)producer_count * sizeof(ingest_ring_t));
+    if (ingest->rings == NULL) {
+        return false;
+    }
+    for (int p = 0; p < producer_count; p++) {
+        atomic_init(&ingest->rings[p].tail, 0);
+        atomic_init(&ingest->rings[p].head, 0);
+        ingest->rings[p].cached_head = 0;
+    }
+    ingest->producer_count = producer_count;
+    atomic_init(&ingest->producers_active, producer_count);
+    ingest->ledger = ledger;
+    return true;
+}
+
+void ingest_free(ingest_t *ingest) {
+    free(ingest->rings);
+    ingest->rings = NULL;
+}
+
+// Producer side: waits while its own ring is full, then publishes one transaction
+void ingest_submit(ingest_t *ingest, int producer, int amount) {
+    ingest_ring_t *ring = &ingest->rings[producer];
+    size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    int spins = 0;
+    while (tail - ring->cached_head == INGEST_RING_SIZE) {
+        ring->cached_head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        if (tail - ring->cached_head == INGEST_RING_SIZE) {
+            spin_backoff(&spins);
+        }
+    }
+
+    ingest_entry_t *entry = &ring->entries[tail & (INGEST_RING_SIZE - 1)];
+    entry->amount = amount;
+    entry->submitted_ns = monotonic_ns();
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+}
+
+// Called once by each producer after its last submit
+void ingest_producer_done(ingest_t *ingest) {
+    atomic_fetch_sub_explicit(&ingest->producers_active, 1, memory_order_release);
+}
+
+// Consumer side: sweeps the rings into a batch, applies it and records each transaction's latency.
+// Returns once every producer is done and all rings are drained.
+void ingest_consume(ingest_t *ingest) {
+    int amounts[INGEST_BATCH];
+    long long submitted[INGEST_BATCH];
+    int spins = 0;
+    int start = 0;
+
+    for (;;) {
+        // Sampled before the sweep: once no producer is active, an empty sweep means nothing else is coming
+        bool finished = atomic_load_explicit(&ingest->producers_active, memory_order_acquire) == 0;
+        int count = 0;
+
+        // Start each sweep at the next ring so a busy producer cannot starve the others
+        for (int n = 0; n < ingest->producer_count && count < INGEST_BATCH; n++) {
+            ingest_ring_t *ring = &ingest->rings[(start + n) % ingest->producer_count];
+            size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+            size_t take = atomic_load_explicit(&ring->tail, memory_order_acquire) - head;
+            if (take > (size_t)(INGEST_BATCH - count)) {
+                take = (size_t)(INGEST_BATCH - count);
+            }
+            for (size_t k = 0; k < take; k++) {
+                const ingest_entry_t *entry = &ring->entries[(head + k) & (INGEST_RING_SIZE - 1)];
+                amounts[count] = entry->amount;
+                submitted[count++] = entry->submitted_ns;
+            }
+            atomic_store_explicit(&ring->head, head + take, memory_order_release);
+        }
+        start = (start + 1) % ingest->producer_count;
+
+        if (count == 0) {
+            if (finished) {
+                break;
+            }
+            spin_backoff(&spins);
+            continue;
+        }
+        spins = 0;
+
+        apply_batch_quiet(ingest->ledger, amounts, count);
+        long long applied_ns = monotonic_ns();
+        for (int i = 0; i < count; i++) {
+            latency_record(&ingest->latency, applied_ns - submitted[i]);
+        }
+    }
+}
+
+// --- LATENCY HISTOGRAM --- //
+static inline int latency_bucket(long long ns) {
+    unsigned long long value = (ns > 0) ? (unsigned long long)ns : 0;
+    if (value < (1u << LATENCY_SUB_BITS)) {
+        return (int)value;
+    }
+    int msb = 63 - __builtin_clzll(value);
+    int group = msb - LATENCY_SUB_BITS + 1;
+    int offset = (int)(value >> (msb - LATENCY_SUB_BITS)) - (1 << LATENCY_SUB_BITS);
+    return (group << LATENCY_SUB_BITS) + offset;
+}
+
+// Largest latency that lands in a bucket
+static long long latency_bucket_limit(int bucket) {
+    int group = bucket >> LATENCY_SUB_BITS;
+    unsigned long long offset = (unsigned long long)(bucket & ((1 << LATENCY_SUB_BITS) - 1));
+    if (group == 0) {
+        return (long long)offset;
+    }
+    return (long long)((((1ULL << LATENCY_SUB_BITS) + offset + 1) << (group - 1)) - 1);
+}
+
+void latency_record(latency_histogram_t *histogram, long long ns) {
+    histogram->counts[latency_bucket(ns)]++;
+    histogram->total++;
+    if (ns > histogram->max_ns) {
+        histogram->max_ns = ns;
+    }
+}
+
+// Latency at or below which the given fraction of samples fall (bucket upper bound, capped at the maximum)
+long long latency_percentile(const latency_histogram_t *histogram, double fraction) {
+    if (histogram->total == 0) {
+        return 0;
+    }
+    unsigned long long target = (unsigned long long)ceil(fraction * (double)histogram->total);
+    unsigned long long seen = 0;
+    for (int b = 0; b < (int)(sizeof(histogram->counts) / sizeof(histogram->counts[0])); b++) {
+        seen += histogram->counts[b];
+        if (seen >= target && seen > 0) {
+            long long limit = latency_bucket_limit(b);
+            return (limit < histogram->max_ns) ? limit : histogram->max_ns;
+        }
+    }
+    return histogram->max_ns;
+}
+
+// --- SHARDED LEDGER BENCHMARK --- //
+// Synthetic account ids drawn from a Zipf(skew) distribution over account_count accounts (skew 0 = uniform)
+static void generate_account_txns(account_txn_t txns[], int count, int account_count, double skew, unsigned int seed) {
+    double *cdf = malloc((size_t)account_count * sizeof(double));
+    double total = 0.0;
+    for (int a = 0; a < account_count && cdf != NULL; a++) {
+        total += 1.0 / pow(a + 1, skew);
+        cdf[a] = total;
+    }
+
+    unsigned int rng = seed;
+    for (int i = 0; i < count; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        int amount = (int)(rng % 500) + 1;
+        txns[i].amount = (rng & 0x30000000u) ? amount : -amount;
+
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        int account = (int)(rng % (unsigned int)account_count);
+        if (cdf != NULL && skew > 0.0) {
+            double target = (double)rng / 4294967296.0 * total;
+            int lo = 0, hi = account_count - 1;
+            while (lo < hi) {
+                int mid = (lo + hi) / 2;
+                if (cdf[mid] < target) lo = mid + 1; else hi = mid;
+            }
+            account = lo;
+        }
+        txns[i].account_id = 100000 + account * 7;    // Sparse ids, like real account numbers
+    }
+    free(cdf);
+}
+
+void benchmark_sharded(void) {
+    static const int account_counts[] = {1000, 100000, 1000000};
+    static const double skews[] = {0.0, 0.99};
+    int txn_count = 8000000;
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_shards = (online > 0) ? (int)online : 1;
+
+    account_txn_t *txns = malloc((size_t)txn_count * sizeof(account_txn_t));
+    if (txns == NULL) {
+        fprintf(stderr, "[CRITICAL] Unable to allocate the benchmark transactions.\n");
+        return;
+    }
+
+    printf("========== SHARDED LEDGER BENCHMARK (%d transactions) ==========\n", txn_count);
+    printf("%10s %6s %7s %12s\n", "accounts", "skew", "shards", "M txn/s");
+    for (size_t a = 0; a < sizeof(account_counts) / sizeof(account_counts[0]); a++) {
+        for (size_t k = 0; k < sizeof(skews) / sizeof(skews[0]); k++) {
+            generate_account_txns(txns, txn_count, account_counts[a], skews[k], 2024);
+            for (int shards = 1;; shards = (shards * 2 < max_shards) ? shards * 2 : max_shards) {
+                sharded_ledger_t ledger;
+                if (!sharded_ledger_init(&ledger, shards)) {
+                    break;
+                }
+                struct timespec start, end;
+                clock_gettime(CLOCK_MONOTONIC, &start);
+                sharded_ledger_apply(&ledger, txns, txn_count);
+                clock_gettime(CLOCK_MONOTONIC, &end);
+                double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+                printf("%10d %6.2f %7d %12.1f\n", account_counts[a], skews[k], shards, txn_count / seconds / 1e6);
+                sharded_ledger_free(&ledger);
+                if (shards == max_shards) {
+                    break;
+                }
+            }
+        }
+    }
+    free(txns);
+}
+
+// --- BATCH THROUGHPUT BENCHMARK --- //
+void benchmark_batches(long long total) {
+    // 16 batches of synthetic transactions (deposits outweigh withdrawals), replayed until total is reached
+    enum { BENCH_BATCHES = 16 };
+    int *txns = malloc((size_t)BENCH_BATCHES * STREAM_BATCH * sizeof(int));
+    ledger_t ledger;
+    if (txns == NULL || !ledger_init(&ledger)) {
+        fprintf(stderr, "[CRITICAL] Unable to allocate the benchmark buffers.\n");
+        free(txns);
+        return;
+    }
+    unsigned int rng = 2024;
+    for (int i = 0; i < BENCH_BATCHES * STREAM_BATCH; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        int amount = (int)(rng % 500) + 1;
+        txns[i] = (rng & 0x30000000u) ? amount : -amount;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (long long done = 0, b = 0; done < total; done += STREAM_BATCH, b = (b + 1) % BENCH_BATCHES) {
+        int count = (total - done < STREAM_BATCH) ? (int)(total - done) : STREAM_BATCH;
+        apply_batch_quiet(&ledger, &txns[b * STREAM_BATCH], count);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+    printf("[PERF] Summary-only apply: %lld transactions in %.3f s (%.1f M txn/s)\n",
+           ledger.txn_seen, seconds, (double)ledger.txn_seen / seconds / 1e6);
+    printf("[DATA] Final balance %lld AED, %lld failed\n", ledger.balance, ledger.failed_txns);
+    ledger_free(&ledger);
+    free(txns);
+}
+
+// --- REPLAY VS TEXT PARSING BENCHMARK --- //
+// Writes the same synthetic transactions as --bench twice: as text lines and as a ledger file
+static bool write_replay_bench_files(int text_fd, int file_fd, long long total) {
+    log_writer_t text;
+    ledger_file_writer_t writer;
+    if (!log_writer_init(&text, text_fd)) {
+        return false;
+    }
+    if (!ledger_file_writer_init(&writer, file_fd)) {
+        log_writer_free(&text);
+        return false;
+    }
+
+    unsigned int rng = 2024;
+    uint32_t now = (uint32_t)time(NULL);
+    bool ok = true;
+    for (long long i = 0; ok && i < total; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        int amount = (int)(rng % 500) + 1;
+        ledger_record_t record = {(rng & 0x30000000u) ? amount : -amount, 0, now};
+        char line[16];
+        int len = snprintf(line, sizeof(line), "%d\n", (int)record.amount);
+        log_writer_append(&text, line, (size_t)len);
+        ok = ledger_file_writer_add(&writer, record);
+    }
+    log_writer_free(&text);
+    ok = ledger_file_writer_finish(&writer) && ok;
+    return ok && !text.failed;
+}
+
+void benchmark_replay(long long total) {
+    char text_path[] = "/tmp/ledger_text_XXXXXX";
+    char file_path[] = "/tmp/ledger_file_XXXXXX";
+    int text_fd = mkstemp(text_path);
+    int file_fd = mkstemp(file_path);
+    int *batch = malloc(STREAM_BATCH * sizeof(int));
+
+    if (text_fd >= 0 && file_fd >= 0 && batch != NULL && write_replay_bench_files(text_fd, file_fd, total)) {
+        printf("========== REPLAY BENCHMARK (%lld transactions) ==========\n", total);
+        printf("%-20s %12s %10s %12s %16s\n", "method", "applied", "seconds", "M txn/s", "final balance");
+        for (int method = 0; method < 3; method++) {
+            static const char *names[] = {"text parse", "mapped replay", "resume checkpoint"};
+            ledger_t ledger;
+            ledger_file_t file;
+            ledger_init(&ledger);
+            long long first = 0;
+
+            struct timespec start, end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            if (method == 0) {
+                single_stream_t ctx = {&ledger, NULL};
+                lseek(text_fd, 0, SEEK_SET);
+                stream_numbers(text_fd, batch, STREAM_BATCH, flush_single_batch, &ctx);
+                ledger_finish(&ledger, NULL);
+            } else if (ledger_file_open(&file, file_path)) {
+                ledger_start_replay(&ledger, &file, method == 2);
+                first = ledger.txn_seen;
+                replay_records(&ledger, &file, NULL);
+                ledger_file_close(&file);
+            }
+            clock_gettime(CLOCK_MONOTONIC, &end);
+
+            double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+            long long applied = ledger.txn_seen - first;
+            printf("%-20s %12lld %10.3f %12.1f %16lld\n", names[method], applied, seconds,
+                   seconds > 0 ? (double)applied / seconds / 1e6 : 0.0, ledger.balance);
+            ledger_free(&ledger);
+        }
+    } else {
+        fprintf(stderr, "[CRITICAL] Unable to set up the replay benchmark.\n");
+    }
+
+    if (text_fd >= 0) {
+        close(text_fd);
+        unlink(text_path);
+    }
+    if (file_fd >= 0) {
+        close(file_fd);
+        unlink(file_path);
+    }
+    free(batch);
+}
+
+// --- CONCURRENT INGESTION BENCHMARK --- //
+typedef struct {
+    ingest_t *ingest;
+    int index;                       // Producer ring to submit on
+    long long count;                 // Transactions to submit
+} ingest_producer_t;
+
+// Simulated front end: submits synthetic transactions (deposits outweigh withdrawals) as fast as it can
+static void *ingest_producer(void *arg) {
+    ingest_producer_t *producer = arg;
+    unsigned int rng = 2024u + 7919u * (unsigned int)producer->index;
+    for (long long i = 0; i < producer->count; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        int amount = (int)(rng % 500) + 1;
+        ingest_submit(producer->ingest, producer->index, (rng & 0x30000000u) ? amount : -amount);
+    }
+    ingest_producer_done(producer->ingest);
+    return NULL;
+}
+
+void benchmark_ingest(int producer_count) {
+    long long per_producer = 2000000;
+    ledger_t ledger;
+    ingest_t ingest;
+    pthread_t *threads = malloc((size_t)producer_count * sizeof(pthread_t));
+    ingest_producer_t *producers = malloc((size_t)producer_count * sizeof(ingest_producer_t));
+    if (threads == NULL || producers == NULL || !ledger_init(&ledger) || !ingest_init(&ingest, producer_count, &ledger)) {
+        fprintf(stderr, "[CRITICAL] Unable to set up the ingestion benchmark.\n");
+        free(threads);
+        free(producers);
+        return;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int started = 0;
+    for (int p = 0; p < producer_count; p++) {
+        producers[p] = (ingest_producer_t){&ingest, p, per_producer};
+        if (pthread_create(&threads[started], NULL, ingest_producer, &producers[p]) == 0) {
+            started++;
+        } else {
+            ingest_producer_done(&ingest); // Its ring simply stays empty
+        }
+    }
+    ingest_consume(&ingest);
+    for (int t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    ledger_finish(&ledger, NULL);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+    printf("========== CONCURRENT INGESTION BENCHMARK (%d producers) ==========\n", started);
+    printf("[PERF] Applied %lld transactions in %.3f s (%.1f M txn/s)\n",
+           ledger.txn_seen, seconds, seconds > 0 ? (double)ledger.txn_seen / seconds / 1e6 : 0.0);
+    printf("[PERF] Submit-to-apply latency: p50 %lld ns, p99 %lld ns, p999 %lld ns, max %lld ns\n",
+           latency_percentile(&ingest.latency, 0.50), latency_percentile(&ingest.latency, 0.99),
+           latency_percentile(&ingest.latency, 0.999), ingest.latency.max_ns);
+    printf("[DATA] Final balance %lld AED, %lld failed\n", ledger.balance, ledger.failed_txns);
+
+    ingest_free(&ingest);
+    ledger_free(&ledger);
+    free(threads);
+    free(producers);
+}
+
+// --- TRANSACTION LOGGER --- //
+void log_transaction(log_writer_t *log, long long txn_id, long long txn_value, long long current_balance) {
+    // Logs each transaction with type (deposit/withdrawal) and updated balance
+    log_event(log, LOG_TXN, txn_id, txn_value, current_balance);
+}
+
+// Renders one log record as terminal text; the same code serves the synchronous and async paths,
+// so the output is identical either way. out must hold LOG_LINE_MAX bytes.
+int format_log_record(const log_record_t *record, char *out) {
+    long long amount = (record->value < 0) ? -record->value : record->value;
+    const char *type = (record->value < 0) ? "Withdrawal" : "Deposit";
+    switch (record->kind) {
+    case LOG_TXN:
+        return snprintf(out, LOG_LINE_MAX, "[TXN] Transaction %lld: %s of %lld AED\n      Updated Balance: %lld AED\n",
+                        record->txn_id, type, amount, record->balance);
+    case LOG_FAILED:
+        return snprintf(out, LOG_LINE_MAX, "[FAILED] Txn %lld: Withdrawal of %lld AED declined (Insufficient Funds).\n",
+                        record->txn_id, amount);
+    case LOG_EXHAUSTED:
+        memcpy(out, MSG_BALANCE_EXHAUSTED, sizeof(MSG_BALANCE_EXHAUSTED) - 1);
+        return (int)sizeof(MSG_BALANCE_EXHAUSTED) - 1;
+    case LOG_RETRY:
+        return snprintf(out, LOG_LINE_MAX, "[RETRY] Txn %lld: %s of %lld AED approved on retry.\n      Updated Balance: %lld AED\n",
+                        record->txn_id, type, amount, record->balance);
+    case LOG_DROPPED:
+        return snprintf(out, LOG_LINE_MAX, "[NOTICE] %lld log records dropped (log queue full).\n", record->value);
+    }
+    return 0;
+}
+
+// --- ASYNC LOG THREAD --- //
+// True when the ring has needed free slots; re-reads the consumer's position only when the cached one says no
+static bool async_log_has_room(async_log_t *async, size_t tail, size_t needed) {
+    if (ASYNC_LOG_RING - (tail - async->cached_head) >= needed) {
+        return true;
+    }
+    async->cached_head = atomic_load_explicit(&async->head, memory_order_acquire);
+    return ASYNC_LOG_RING - (tail - async->cached_head) >= needed;
+}
+
+// Processing-thread side: queues one record, applying the backpressure policy when the ring is full
+static void async_log_push(async_log_t *async, const log_record_t *record) {
+    size_t tail = atomic_load_explicit(&async->tail, memory_order_relaxed);
+    size_t needed = (async->unreported > 0) ? 2 : 1;   // Room for the drop notice too, when one is owed
+    int spins = 0;
+    while (!async_log_has_room(async, tail, needed)) {
+        if (async->policy != LOG_BLOCK) {
+            async->dropped++;
+            async->unreported += (async->policy == LOG_COUNT);
+            return;
+        }
+        spin_backoff(&spins);
+    }
+    if (needed == 2) {
+        log_record_t notice = {0, (long long)async->unreported, 0, LOG_DROPPED};
+        async->ring[tail++ & (ASYNC_LOG_RING - 1)] = notice;
+        async->unreported = 0;
+    }
+    async->ring[tail & (ASYNC_LOG_RING - 1)] = *record;
+    atomic_store_explicit(&async->tail, tail + 1, memory_order_release);
+}
+
+// Hands a log record to the log thread, or formats it into the buffer when logging synchronously
+void log_event(log_writer_t *log, log_kind_t kind, long long txn_id, long long value, long long balance) {
+    log_record_t record = {txn_id, value, balance, kind};
+    if (log->async != NULL) {
+        async_log_push(log->async, &record);
+        return;
+    }
+    if (log->capacity - log->used < LOG_LINE_MAX) {
+        log_writer_flush(log);
+    }
+    log->used += (size_t)format_log_record(&record, log->buf + log->used);
+}
+
+// Writes every segment, resuming after short and interrupted writes; false if the output is gone
+static bool write_segments(int fd, struct iovec *iov, int count) {
+    while (count > 0) {
+        ssize_t n = writev(fd, iov, count);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        while (count > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+    return true;
+}
+
+// Log thread: formats whatever is queued into up to ASYNC_LOG_SEGMENTS segments and writes them in one writev
+static void *async_log_worker(void *arg) {
+    async_log_t *async = arg;
+    struct iovec iov[ASYNC_LOG_SEGMENTS];
+    int idle = 0;
+
+    for (;;) {
+        // Sampled before reading tail: once stopping is seen, an empty ring means the producer is done
+        bool stopping = atomic_load_explicit(&async->stopping, memory_order_acquire);
+        size_t head = atomic_load_explicit(&async->head, memory_order_relaxed);
+        size_t tail = atomic_load_explicit(&async->tail, memory_order_acquire);
+        if (head == tail) {
+            if (stopping) {
+                break;
+            }
+            if (idle < 64) {
+                idle++;
+                sched_yield();
+            } else {
+                struct timespec pause = {0, 100000};   // Nothing to do for a while: stop polling hard
+                nanosleep(&pause, NULL);
+            }
+            continue;
+        }
+        idle = 0;
+
+        int segments = 0;
+        size_t used = 0;
+        while (head != tail) {
+            if (ASYNC_LOG_SEGMENT - used < LOG_LINE_MAX) {
+                iov[segments].iov_base = async->text + (size_t)segments * ASYNC_LOG_SEGMENT;
+                iov[segments].iov_len = used;
+                used = 0;
+                if (++segments == ASYNC_LOG_SEGMENTS) {
+                    break;
+                }
+            }
+            char *out = async->text + (size_t)segments * ASYNC_LOG_SEGMENT + used;
+            used += (size_t)format_log_record(&async->ring[head & (ASYNC_LOG_RING - 1)], out);
+            head++;
+        }
+        if (used > 0) {
+            iov[segments].iov_base = async->text + (size_t)segments * ASYNC_LOG_SEGMENT;
+            iov[segments].iov_len = used;
+            segments++;
+        }
+        atomic_store_explicit(&async->head, head, memory_order_release); // Slots are free once formatted
+
+        if (!atomic_load_explicit(&async->failed, memory_order_relaxed) && !write_segments(async->fd, iov, segments)) {
+            atomic_store_explicit(&async->failed, true, memory_order_relaxed); // Keep draining so the producer never stalls
+        }
+        atomic_store_explicit(&async->written, head, memory_order_release);
+    }
+    return NULL;
+}
+
+// Moves a log writer's formatting and writing onto its own thread. Stays synchronous (and returns
+// false) for LOG_SYNC or when the thread cannot be started.
+bool log_writer_start_async(log_writer_t *log, log_policy_t policy) {
+    if (policy == LOG_SYNC || log->async != NULL) {
+        return false;
+    }
+    async_log_t *async = aligned_alloc(64, sizeof(async_log_t));
+    if (async == NULL) {
+        return false;
+    }
+    memset(async, 0, sizeof(*async));
+    async->ring = malloc(ASYNC_LOG_RING * sizeof(log_record_t));
+    async->text = malloc((size_t)ASYNC_LOG_SEGMENTS * ASYNC_LOG_SEGMENT);
+    atomic_init(&async->tail, 0);
+    atomic_init(&async->head, 0);
+    atomic_init(&async->written, 0);
+    atomic_init(&async->stopping, false);
+    atomic_init(&async->failed, false);
+    async->policy = policy;
+    async->fd = log->fd;
+
+    log_writer_flush(log); // Anything buffered so far goes out before the thread's first write
+    if (async->ring == NULL || async->text == NULL ||
+        pthread_create(&async->thread, NULL, async_log_worker, async) != 0) {
+        fprintf(stderr, "[NOTICE] Log thread unavailable; logging synchronously.\n");
+        free(async->ring);
+        free(async->text);
+        free(async);
+        return false;
+    }
+    log->async = async;
+    return true;
+}
+
+// Waits for the log thread to write out everything queued so far, then stops it
+static void async_log_stop(log_writer_t *log) {
+    async_log_t *async = log->async;
+    if (async->unreported > 0) {
+        // Report the last drops even if that means waiting for room
+        log_record_t notice = {0, (long long)async->unreported, 0, LOG_DROPPED};
+        async->unreported = 0;
+        async->policy = LOG_BLOCK;
+        async_log_push(async, &notice);
+    }
+    atomic_store_explicit(&async->stopping, true, memory_order_release);
+    pthread_join(async->thread, NULL);
+
+    log->dropped += async->dropped;
+    log->failed = log->failed || atomic_load(&async->failed);
+    if (async->dropped > 0 && async->policy == LOG_DROP) {
+        fprintf(stderr, "[NOTICE] %llu log records dropped (log queue full).\n", async->dropped);
+    }
+    free(async->ring);
+    free(async->text);
+    free(async);
+    log->async = NULL;
+}
+
+// --- BUFFERED LOG WRITER --- //
+bool log_writer_init(log_writer_t *log, int fd) {
+    log->fd = fd;
+    log->used = 0;
+    log->capacity = LOG_BUFFER_SIZE;
+    log->failed = false;
+    log->async = NULL;
+    log->dropped = 0;
+    log->buf = malloc(log->capacity);
+    return log->buf != NULL;
+}
+
+// Writes out everything collected so far, retrying short and interrupted writes.
+// With a log thread, waits until it has written every record queued so far.
+void log_writer_flush(log_writer_t *log) {
+    if (log->async != NULL) {
+        size_t queued = atomic_load_explicit(&log->async->tail, memory_order_relaxed);
+        int spins = 0;
+        while (atomic_load_explicit(&log->async->written, memory_order_acquire) != queued) {
+            spin_backoff(&spins);
+        }
+        return;
+    }
+
+    size_t done = 0;
+    while (done < log->used) {
+        ssize_t n = write(log->fd, log->buf + done, log->used - done);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            log->failed = true;
+            break; // Output is gone (closed pipe, full disk): drop the rest of this chunk
+        }
+        done += (size_t)n;
+    }
+    log->used = 0;
+}
+
+// Copies raw bytes into the buffer, flushing first when they would not fit (synchronous writers only)
+void log_writer_append(log_writer_t *log, const char *text, size_t len) {
+    if (log->capacity - log->used < len) {
+        log_writer_flush(log);
+    }
+    memcpy(log->buf + log->used, text, len);
+    log->used += len;
+}
+
+void log_writer_free(log_writer_t *log) {
+    if (log->async != NULL) {
+        async_log_stop(log);
+    }
+    log_writer_flush(log);
+    free(log->buf);
+    log->buf = NULL;
+}
+
+// --- ASYNC LOGGING BENCHMARK --- //
+// Logged processing into /dev/null under each policy: time until processing returns, and until the log is out
+void benchmark_logging(long long total) {
+    enum { BENCH_BATCHES = 16 };
+    int *txns = malloc((size_t)BENCH_BATCHES * STREAM_BATCH * sizeof(int));
+    int sink = open("/dev/null", O_WRONLY);
+    if (txns == NULL || sink < 0) {
+        fprintf(stderr, "[CRITICAL] Unable to set up the logging benchmark.\n");
+        free(txns);
+        if (sink >= 0) {
+            close(sink);
+        }
+        return;
+    }
+    unsigned int rng = 2024;
+    for (int i = 0; i < BENCH_BATCHES * STREAM_BATCH; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        int amount = (int)(rng % 500) + 1;
+        txns[i] = (rng & 0x30000000u) ? amount : -amount;
+    }
+
+    static const char *names[] = {"sync", "block", "drop", "count"};
+    printf("========== LOG DELIVERY BENCHMARK (%lld logged transactions) ==========\n", total);
+    printf("%-8s %14s %14s %14s\n", "policy", "processing s", "log done s", "dropped");
+    for (int policy = LOG_SYNC; policy <= LOG_COUNT; policy++) {
+        ledger_t ledger;
+        log_writer_t log;
+        if (!ledger_init(&ledger) || !log_writer_init(&log, sink)) {
+            continue;
+        }
+        log_writer_start_async(&log, (log_policy_t)policy);
+
+        struct timespec start, processed, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (long long done = 0, b = 0; done < total; done += STREAM_BATCH, b = (b + 1) % BENCH_BATCHES) {
+            int count = (total - done < STREAM_BATCH) ? (int)(total - done) : STREAM_BATCH;
+            apply_batch(&ledger, &txns[b * STREAM_BATCH], count, &log);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &processed);
+        log_writer_free(&log);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        printf("%-8s %14.3f %14.3f %14llu\n", names[policy],
+               (double)(processed.tv_sec - start.tv_sec) + (double)(processed.tv_nsec - start.tv_nsec) * 1e-9,
+               (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9, log.dropped);
+        ledger_free(&ledger);
+    }
+
+    close(sink);
+    free(txns);
+}
+
+// --- DISPLAY PENDING TRANSACTIONS --- //
+void display_pending(const long long pending_txn[], int count) {
+    // Output of all the unprocessed transactions
+    for (int i = 0; i < count; i++) {
+        printf("[PENDING] Unprocessed Transactions >> %lld AED.\n", pending_txn[i]);
+    }
+}
+
+// --- TRANSACTION SUMMARY --- //
+void show_summary(long long deposits, long long withdrawals, long long failed_txns) {
+    printf("\n========== TRANSACTION SUMMARY ==========\n");
+    printf("[DATA] Total Deposits      : %lld AED\n", deposits);
+    printf("[DATA] Total Withdrawals   : %lld AED\n", withdrawals);
+    printf("[DATA] Failed Transactions : %lld\n", failed_txns);
+}
+
+// --- PHASE STATISTICS --- //
+// Turns the per-phase hooks on and calibrates instr_ticks() against the monotonic clock
+void phase_stats_enable(void) {
+    static phase_stats_t stats;
+    memset(&stats, 0, sizeof(stats));
+
+    struct timespec start, end, pause = {0, 20000000};
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    unsigned long long first = instr_ticks();
+    nanosleep(&pause, NULL);
+    unsigned long long last = instr_ticks();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double ns = (double)(end.tv_sec - start.tv_sec) * 1e9 + (double)(end.tv_nsec - start.tv_nsec);
+    stats.ticks_per_ns = (ns > 0 && last > first) ? (double)(last - first) / ns : 1.0;
+
+    phase_stats = &stats;
+}
+
+void show_phase_stats(const phase_stats_t *stats) {
+    static const char *names[PHASE_COUNT] = {"Parse", "Validate", "Apply", "Log"};
+    printf("\n========== PHASE TIMINGS ==========\n");
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        if (stats->items[p] == 0 && stats->ticks[p] == 0) {
+            continue;
+        }
+        double ns = (double)stats->ticks[p] / stats->ticks_per_ns;
+        printf("[PERF] %-9s: %llu items in %.3f ms (%.1f ns each)\n", names[p], stats->items[p], ns / 1e6,
+               stats->items[p] > 0 ? ns / (double)stats->items[p] : 0.0);
+    }
+}
+
+// --- INSTRUMENTATION OVERHEAD BENCHMARK --- //
+// Logged processing into /dev/null with the hooks compiled out, compiled in but disabled, and enabled
+void benchmark_instrumentation(long long total) {
+    enum { BENCH_BATCHES = 16, BENCH_ROUNDS = 5 };
+    int *txns = malloc((size_t)BENCH_BATCHES * STREAM_BATCH * sizeof(int));
+    int sink = open("/dev/null", O_WRONLY);
+    if (txns == NULL || sink < 0) {
+        fprintf(stderr, "[CRITICAL] Unable to set up the instrumentation benchmark.\n");
+        free(txns);
+        if (sink >= 0) {
+            close(sink);
+        }
+        return;
+    }
+    unsigned int rng = 2024;
+    for (int i = 0; i < BENCH_BATCHES * STREAM_BATCH; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        int amount = (int)(rng % 500) + 1;
+        txns[i] = (rng & 0x30000000u) ? amount : -amount;
+    }
+
+    phase_stats_t *saved = phase_stats;
+    phase_stats_enable();
+    phase_stats_t *enabled = phase_stats;
+
+    // Rounds interleave the modes so drift in machine load hits all three alike
+    static const char *modes[] = {"hooks compiled out", "hooks disabled", "hooks enabled"};
+    double best[3] = {0.0, 0.0, 0.0};
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        for (int mode = 0; mode < 3; mode++) {
+            ledger_t ledger;
+            log_writer_t log;
+            if (!ledger_init(&ledger) || !log_writer_init(&log, sink)) {
+                continue;
+            }
+            phase_stats = (mode == 2) ? enabled : NULL;
+
+            struct timespec start, end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            for (long long done = 0, b = 0; done < total; done += STREAM_BATCH, b = (b + 1) % BENCH_BATCHES) {
+                int count = (total - done < STREAM_BATCH) ? (int)(total - done) : STREAM_BATCH;
+                if (mode == 0) {
+                    apply_logged(&ledger, &txns[b * STREAM_BATCH], NULL, count, &log, NULL);
+                } else {
+                    apply_batch(&ledger, &txns[b * STREAM_BATCH], count, &log);
+                }
+            }
+            log_writer_flush(&log);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+
+            double seconds = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+            best[mode] = (round == 0 || seconds < best[mode]) ? seconds : best[mode];
+            log_writer_free(&log);
+            ledger_free(&ledger);
+        }
+    }
+
+    printf("========== INSTRUMENTATION OVERHEAD (%lld logged transactions, best of %d) ==========\n", total, BENCH_ROUNDS);
+    for (int mode = 0; mode < 3; mode++) {
+        printf("[PERF] %-19s: %.3f s (%.1f ns/txn, %+.2f%%)\n", modes[mode], best[mode], best[mode] / (double)total * 1e9,
+               best[0] > 0 ? (best[mode] / best[0] - 1.0) * 100.0 : 0.0);
+    }
+    phase_stats = saved;
+
+    // Timestamp text: cached per second versus formatting on every call
+    enum { STAMP_CALLS = 1000000 };
+    struct timespec start, end;
+    size_t checksum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < STAMP_CALLS; i++) {
+        checksum += (size_t)get_time_stamp()[18];
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double cached = ((double)(end.tv_sec - start.tv_sec) * 1e9 + (double)(end.tv_nsec - start.tv_nsec)) / STAMP_CALLS;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < STAMP_CALLS; i++) {
+        char text[20];
+        time_t t = time(NULL);
+        struct tm time_info;
+        localtime_r(&t, &time_info);
+        strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", &time_info);
+        checksum += (size_t)text[18];
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double uncached = ((double)(end.tv_sec - start.tv_sec) * 1e9 + (double)(end.tv_nsec - start.tv_nsec)) / STAMP_CALLS;
+    printf("[PERF] Timestamp text: %.1f ns cached, %.1f ns formatted per call (checksum %zu)\n", cached, uncached, checksum);
+
+    close(sink);
+    free(txns);
+}
+
+// --- GET CURRENT TIMESTAMP --- //
+// Formats at most once per second per thread: reading the coarse clock costs a few ns,
+// localtime + strftime cost far more. The buffer is thread-local, so callers on other threads are safe.
+const char* get_time_stamp() {
+    static _Thread_local time_stamp_cache_t cache = {-1, ""};
+    struct timespec now;
+#ifdef CLOCK_REALTIME_COARSE
+    clock_gettime(CLOCK_REALTIME_COARSE, &now);
+#else
+    clock_gettime(CLOCK_REALTIME, &now);
+#endif
+    if (now.tv_sec != cache.second) {
+        struct tm time_info;
+        localtime_r(&now.tv_sec, &time_info);
+        strftime(cache.text, sizeof(cache.text), "%Y-%m-%d %H:%M:%S", &time_info);
+        cache.second = now.tv_sec;
+    }
+    return cache.text;
+}
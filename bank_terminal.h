@@ -0,0 +1,360 @@
+// Banking terminal: ledgers with pending retries, streaming and sharded processing, binary ledger
+// files, concurrent ingestion and the transaction log. The demo program in main (2).c drives it.
+#ifndef BANK_TERMINAL_H
+#define BANK_TERMINAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+
+// --- CORE PARAMETERS --- //
+#define BASE_BALANCE 1000            // Default starting balance
+#define TRANSACTION_LIMIT 100        // Maximum allowable bank account transactions
+#define STREAM_BATCH 65536           // Transactions parsed and applied per batch in streaming mode
+#define STREAM_READ_SIZE (1 << 20)   // Bytes requested per read(2) in streaming mode
+#define LOG_BUFFER_SIZE (1 << 20)    // Bytes collected before the log is written out
+#define PENDING_CHUNK 4096           // Pending entries per arena chunk
+#define DEFAULT_MAX_RETRIES 3        // Retry passes a declined transaction gets before it is left pending
+#define LEDGER_CHECKPOINT_INTERVAL (16 * STREAM_BATCH) // Records between balance checkpoints in a ledger file
+#define LEDGER_MAGIC "AEDLEDG1"      // First bytes of a binary ledger file
+#define LEDGER_VERSION 1
+#define INGEST_RING_SIZE 4096        // Slots per producer ring (power of two)
+#define INGEST_BATCH 1024            // Transactions the ingest consumer applies at once
+#define LATENCY_SUB_BITS 4           // Latency histogram resolution: 16 buckets per power of two
+#define ASYNC_LOG_RING (1 << 16)     // Log records queued for the log thread (power of two)
+#define ASYNC_LOG_SEGMENT (1 << 16)  // Bytes of formatted text per writev segment
+#define ASYNC_LOG_SEGMENTS 16        // Segments handed to one writev call
+#define LOG_LINE_MAX 160             // Longest text a single log record formats to
+
+#define MSG_BALANCE_EXHAUSTED "[CRITICAL] Balance exhausted. Cannot process further transactions.\n"
+
+// --- PENDING / RETRY QUEUE --- //
+typedef struct {
+    long long txn_id;                // Position of the transaction in the input
+    long long amount;                // Declined amount (negative for withdrawals); ledger file records are 64-bit
+    int attempts;                    // Retry passes it has already failed
+} pending_entry_t;
+
+typedef struct pending_chunk {
+    struct pending_chunk *next;      // Next (younger) chunk in the queue
+    pending_entry_t entries[PENDING_CHUNK];
+} pending_chunk_t;
+
+typedef struct {
+    pending_chunk_t *head;           // Oldest chunk, entries are taken from here
+    pending_chunk_t *tail;           // Youngest chunk, entries are added here
+    int head_pos;                    // Next entry to take in head
+    int tail_pos;                    // Next free entry in tail
+    size_t count;                    // Entries in the queue
+    pending_chunk_t *spare;          // Emptied chunks kept for reuse
+} pending_queue_t;
+
+typedef struct {
+    const pending_chunk_t *chunk;    // Chunk holding the next entry
+    int pos;                         // Index of the next entry in chunk
+    size_t remaining;                // Entries left to visit
+} pending_cursor_t;
+
+typedef enum {
+    RETRY_NONE,                      // Declined transactions only go to the pending report
+    RETRY_ON_DEPOSIT,                // Queued transactions are retried after every successful deposit
+    RETRY_AT_END                     // One retry pass once the whole input has been applied
+} retry_mode_t;
+
+typedef struct {
+    retry_mode_t mode;
+    int max_attempts;                // Failed retry passes before an entry is left pending for good
+} retry_policy_t;
+
+// --- LEDGER STATE --- //
+typedef struct {
+    long long balance;               // Current account balance
+    long long total_deposits;        // Total amount deposited
+    long long total_withdrawals;     // Total amount withdrawn
+    long long failed_txns;           // Total number of failed transactions
+    long long txn_seen;              // Transactions processed so far (next id is txn_seen + 1)
+    long long recovered_txns;        // Declined transactions that went through on a retry
+    pending_queue_t pending;         // Declined transactions still eligible for retry
+    pending_queue_t abandoned;       // Declined transactions out of retry attempts
+    long long unlisted_txns;         // Left unprocessed before a resumed checkpoint (amounts not kept)
+    retry_policy_t policy;           // How declined transactions are retried
+} ledger_t;
+
+// --- BUFFERED LOG WRITER --- //
+typedef enum {
+    LOG_TXN,                         // Applied transaction and the balance after it
+    LOG_FAILED,                      // Withdrawal declined for insufficient funds
+    LOG_EXHAUSTED,                   // Transaction refused because the balance is zero
+    LOG_RETRY,                       // Declined transaction approved on a retry pass
+    LOG_DROPPED                      // Records lost to a full queue (value = how many)
+} log_kind_t;
+
+typedef struct {
+    long long txn_id;
+    long long value;                 // Transaction amount (or dropped count)
+    long long balance;               // Balance after the transaction
+    log_kind_t kind;
+} log_record_t;
+
+typedef enum {
+    LOG_SYNC,                        // Format and write on the processing thread
+    LOG_BLOCK,                       // Log thread; a full queue makes processing wait
+    LOG_DROP,                        // Log thread; records that do not fit are discarded
+    LOG_COUNT                        // Log thread; discarded records are reported by a notice line
+} log_policy_t;
+
+struct async_log;
+
+typedef struct {
+    int fd;                          // Destination file descriptor
+    char *buf;                       // Pending log text
+    size_t used;                     // Bytes waiting in buf
+    size_t capacity;                 // Size of buf
+    bool failed;                     // A write failed and output was dropped
+    struct async_log *async;         // Background formatter/writer, NULL when logging synchronously
+    unsigned long long dropped;      // Records the async queue discarded (LOG_DROP / LOG_COUNT)
+} log_writer_t;
+
+// Single-producer ring of log records, drained by a dedicated thread
+typedef struct async_log {
+    _Alignas(64) atomic_size_t tail; // Next slot the processing thread fills
+    size_t cached_head;              // Processing thread's last view of head
+    unsigned long long dropped;      // Records discarded so far
+    unsigned long long unreported;   // Discarded records not yet announced (LOG_COUNT)
+    _Alignas(64) atomic_size_t head; // Next slot the log thread formats
+    atomic_size_t written;           // Records whose text has been written out
+    atomic_bool stopping;
+    atomic_bool failed;
+    log_policy_t policy;
+    int fd;
+    pthread_t thread;
+    log_record_t *ring;              // ASYNC_LOG_RING records
+    char *text;                      // ASYNC_LOG_SEGMENTS formatted segments, owned by the log thread
+} async_log_t;
+
+// --- MULTI-ACCOUNT LEDGER STATE --- //
+typedef struct {
+    int account_id;                  // Account the transaction belongs to
+    long long amount;                // Positive for deposits, negative for withdrawals
+} account_txn_t;
+
+typedef struct {
+    int account_id;                  // Key of an occupied slot
+    bool in_use;                     // Slot holds an account
+    long long balance;               // Current account balance
+    long long total_deposits;        // Amount deposited into this account
+    long long total_withdrawals;     // Amount withdrawn from this account
+    long long failed_txns;           // Declined transactions for this account
+} account_t;
+
+struct sharded_ledger;
+
+typedef struct {
+    account_t *accounts;             // Open-addressing table of this shard's accounts
+    size_t capacity;                 // Slots in accounts (power of two)
+    size_t account_count;            // Occupied slots
+    account_txn_t *inbox;            // This batch's transactions for the shard, in arrival order
+    int inbox_count;
+    long long total_deposits;        // Shard totals, merged for the summary
+    long long total_withdrawals;
+    long long failed_txns;
+    long long txn_seen;
+    pthread_t thread;                // Worker thread (shard 0, and any shard whose thread failed, runs on the caller)
+    bool has_thread;
+    sem_t batch_ready;               // Posted when the inbox is filled
+    struct sharded_ledger *owner;
+} ledger_shard_t;
+
+typedef struct sharded_ledger {
+    int shard_count;
+    ledger_shard_t *shards;
+    sem_t batch_done;                // Posted by each worker after applying its inbox
+    int worker_count;                // Shards with their own thread
+    bool stopping;
+} sharded_ledger_t;
+
+// --- STREAM TOKENIZER STATE --- //
+typedef struct {
+    long long value;                 // Digits of the number being read
+    bool in_number;                  // Inside a run of digits
+    bool negative;                   // The current number started with '-'
+    long long rejected;              // Numbers dropped for not fitting in an int
+} num_parser_t;
+
+// --- BINARY LEDGER FILE --- //
+// Layout: header | record_count records | checkpoint_count checkpoints, in host byte order
+typedef struct {
+    char magic[8];                   // LEDGER_MAGIC
+    uint32_t version;                // LEDGER_VERSION
+    uint32_t record_size;            // sizeof(ledger_record_t), checked on open
+    uint64_t record_count;
+    int64_t base_balance;            // Balance before the first record
+    uint64_t checkpoint_interval;    // Records between checkpoints
+    uint64_t checkpoint_count;
+    uint64_t checkpoint_offset;      // Byte offset of the checkpoint table
+    uint32_t retry_mode;             // Retry policy the checkpoints were computed under
+    uint32_t retry_max_attempts;
+} ledger_file_header_t;
+
+typedef struct {
+    int64_t amount;                  // Positive for deposits, negative for withdrawals
+    uint32_t account_id;             // Account the transaction belongs to
+    uint32_t timestamp;              // Seconds since the epoch
+} ledger_record_t;
+
+typedef struct {
+    uint64_t record_index;           // Records applied before this snapshot
+    int64_t balance;
+    int64_t total_deposits;
+    int64_t total_withdrawals;
+    int64_t failed_txns;
+    int64_t recovered_txns;
+    uint64_t pending_count;          // Declined transactions still queued for retry
+    uint64_t abandoned_count;        // Declined transactions out of retries
+} ledger_checkpoint_t;
+
+typedef struct {
+    void *map;                       // Whole file, mapped read-only
+    size_t map_size;
+    const ledger_file_header_t *header;
+    const ledger_record_t *records;
+    const ledger_checkpoint_t *checkpoints;
+} ledger_file_t;
+
+typedef struct {
+    int fd;
+    log_writer_t out;                // Buffered output; the header is patched in at the end
+    ledger_t ledger;                 // Replays the records as they are written, for the checkpoints
+    ledger_record_t *chunk;          // Records not yet applied to ledger
+    int chunk_count;
+    ledger_checkpoint_t *checkpoints;
+    size_t checkpoint_count;
+    size_t checkpoint_capacity;
+} ledger_file_writer_t;
+
+// --- CONCURRENT INGESTION --- //
+typedef struct {
+    int amount;                      // Positive for deposits, negative for withdrawals
+    long long submitted_ns;          // Monotonic time the producer handed it over
+} ingest_entry_t;
+
+// Single-producer single-consumer ring: each index has one writer, so no locks or CAS are needed
+typedef struct {
+    _Alignas(64) atomic_size_t tail; // Next slot the producer fills (written by the producer only)
+    size_t cached_head;              // Producer's last view of head, refreshed only when the ring looks full
+    _Alignas(64) atomic_size_t head; // Next slot the consumer takes (written by the consumer only)
+    _Alignas(64) ingest_entry_t entries[INGEST_RING_SIZE];
+} ingest_ring_t;
+
+// Log-linear latency buckets: exact below 2^LATENCY_SUB_BITS ns, then 2^LATENCY_SUB_BITS buckets per power of two
+typedef struct {
+    unsigned long long counts[(64 - LATENCY_SUB_BITS + 1) << LATENCY_SUB_BITS];
+    unsigned long long total;
+    long long max_ns;
+} latency_histogram_t;
+
+typedef struct {
+    ingest_ring_t *rings;            // One ring per producer
+    int producer_count;
+    atomic_int producers_active;     // Producers that have not called ingest_producer_done yet
+    ledger_t *ledger;                // Only the consumer touches it
+    latency_histogram_t latency;     // Submit-to-apply time, filled by the consumer
+} ingest_t;
+
+// --- INSTRUMENTATION --- //
+typedef enum {
+    PHASE_PARSE,                     // Tokenizing input text into amounts
+    PHASE_VALIDATE,                  // Balance checks before a transaction is applied
+    PHASE_APPLY,                     // Balance and total updates, retry passes
+    PHASE_LOG,                       // Formatting and buffering log text
+    PHASE_COUNT
+} phase_t;
+
+typedef struct {
+    unsigned long long items[PHASE_COUNT];  // Transactions (or numbers, for parse) that went through each phase
+    unsigned long long ticks[PHASE_COUNT];  // Time spent in each phase, in instr_ticks() units
+    double ticks_per_ns;                    // Calibrated once, when the stats are enabled
+} phase_stats_t;
+
+typedef struct {
+    time_t second;                   // Wall-clock second text was formatted for
+    char text[20];                   // "YYYY-MM-DD HH:MM:SS"
+} time_stamp_cache_t;
+
+// --- TERMINAL SETTINGS --- //
+extern retry_policy_t retry_policy; // Retry policy used for every new ledger
+extern log_policy_t log_policy;     // Log delivery used by the terminals
+
+// --- FUNCTION DECLARATIONS --- //
+void execute_transactions(const int txn_list[], int txn_count);
+void log_transaction(log_writer_t *log, long long txn_id, long long txn_value, long long current_balance);
+void display_pending(const long long pending_txn[], int count);
+void show_summary(long long deposits, long long withdrawals, long long failed_txns);
+const char* get_time_stamp(); // For adding timestamps to the logs
+
+void phase_stats_enable(void);
+void show_phase_stats(const phase_stats_t *stats);
+void benchmark_instrumentation(long long total);
+
+bool ledger_init(ledger_t *ledger);
+void ledger_free(ledger_t *ledger);
+void ledger_retry(ledger_t *ledger, log_writer_t *log);
+void ledger_finish(ledger_t *ledger, log_writer_t *log);
+
+void pending_init(pending_queue_t *queue);
+void pending_free(pending_queue_t *queue);
+bool pending_push(pending_queue_t *queue, pending_entry_t entry);
+bool pending_pop(pending_queue_t *queue, pending_entry_t *entry);
+pending_cursor_t pending_cursor(const pending_queue_t *queue);
+const pending_entry_t *pending_next(pending_cursor_t *cursor);
+void apply_batch(ledger_t *ledger, const int txns[], int count, log_writer_t *log);
+void apply_batch_quiet(ledger_t *ledger, const int txns[], int count);
+void apply_records(ledger_t *ledger, const ledger_record_t records[], int count, log_writer_t *log);
+void apply_records_quiet(ledger_t *ledger, const ledger_record_t records[], int count);
+void report_ledger(const ledger_t *ledger);
+int execute_transaction_stream(int fd, bool quiet);
+int parse_numbers(num_parser_t *parser, const char *buf, size_t len, int out[], int max, size_t *used);
+int parse_numbers_finish(num_parser_t *parser, int out[]);
+void benchmark_batches(long long total);
+
+bool sharded_ledger_init(sharded_ledger_t *ledger, int shard_count);
+void sharded_ledger_free(sharded_ledger_t *ledger);
+void sharded_ledger_apply(sharded_ledger_t *ledger, const account_txn_t txns[], int count);
+void report_sharded_ledger(const sharded_ledger_t *ledger);
+int execute_account_stream(int fd, int shard_count);
+void benchmark_sharded(void);
+
+bool ledger_file_open(ledger_file_t *file, const char *path);
+void ledger_file_close(ledger_file_t *file);
+const ledger_checkpoint_t *ledger_file_checkpoint(const ledger_file_t *file, const retry_policy_t *policy);
+bool ledger_file_writer_init(ledger_file_writer_t *writer, int fd);
+bool ledger_file_writer_add(ledger_file_writer_t *writer, ledger_record_t record);
+bool ledger_file_writer_finish(ledger_file_writer_t *writer);
+int convert_csv_ledger(const char *csv_path, const char *out_path);
+int execute_ledger_replay(const char *path, bool quiet, bool resume);
+int execute_account_replay(const char *path, int shard_count);
+void benchmark_replay(long long total);
+
+bool ingest_init(ingest_t *ingest, int producer_count, ledger_t *ledger);
+void ingest_free(ingest_t *ingest);
+void ingest_submit(ingest_t *ingest, int producer, int amount);
+void ingest_producer_done(ingest_t *ingest);
+void ingest_consume(ingest_t *ingest);
+void latency_record(latency_histogram_t *histogram, long long ns);
+long long latency_percentile(const latency_histogram_t *histogram, double fraction);
+void benchmark_ingest(int producer_count);
+
+bool log_writer_init(log_writer_t *log, int fd);
+void log_writer_append(log_writer_t *log, const char *text, size_t len);
+void log_writer_flush(log_writer_t *log);
+void log_writer_free(log_writer_t *log);
+bool log_writer_start_async(log_writer_t *log, log_policy_t policy);
+void log_event(log_writer_t *log, log_kind_t kind, long long txn_id, long long value, long long balance);
+int format_log_record(const log_record_t *record, char *out);
+void benchmark_logging(long long total);
+
+#endif
@@ -0,0 +1,1360 @@
+// Benchmark and regression harness for the array toolkit, the bank terminal and the league library.
+// Pins the behaviour the demo programs rely on, then times each library on synthetic inputs and
+// writes one JSON object per benchmark, so two runs (two commits) can be compared.
+//
+//   harness [--quick] [--filter PREFIX] [--json FILE] [--check-only]
+//   harness --compare BASE.json NEW.json [--tolerance FRACTION]
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "array_toolkit.h"
+#include "bank_terminal.h"
+#include "league.h"
+
+// --- HARNESS SETTINGS --- //
+#ifndef HARNESS_REVISION
+#define HARNESS_REVISION "unknown"      // Set by the build from git describe
+#endif
+#define MAX_SAMPLES 64                  // Timed batches kept per benchmark
+#define MAX_RESULTS 128                 // Benchmarks a compared JSON file may hold
+#define DEFAULT_TOLERANCE 0.10          // Throughput drop tolerated by --compare
+#define CHECK_POOL_THREADS 4            // Pool size forced by the parallel checks, whatever the machine has
+#define CHECK_PARALLEL_LENGTH ((1 << 18) + 1) // Over the parallel cut-off, and not a multiple of the chunk count
+
+// One benchmark: the same batch of items timed samples times
+typedef struct {
+    const char *name;                   // group.benchmark, the key --compare matches on
+    long long items;                    // Items (elements, transactions, lookups) in one batch
+    int samples;
+    double ns[MAX_SAMPLES];             // Wall time of each batch
+    size_t bytes;                       // Memory held by the inputs and the structure under test
+} bench_result_t;
+
+typedef struct {
+    bool quick;                         // Smaller inputs and fewer samples, for a smoke run
+    const char *filter;                 // Only benchmarks whose name starts with this
+    FILE *json;                         // JSON lines go here; stdout gets a table when this is a file
+} harness_options_t;
+
+typedef struct {
+    char name[64];
+    double items_per_sec;
+    double p99_ns;
+} compare_entry_t;
+
+static harness_options_t options;
+static int check_failures = 0;
+
+// --- TIMING AND MEMORY --- //
+// Monotonic wall clock in nanoseconds
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Peak resident set of the process so far, in KiB
+static long peak_rss_kb(void) {
+    struct rusage usage;
+    return (getrusage(RUSAGE_SELF, &usage) == 0) ? usage.ru_maxrss : -1;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted values
+static double percentile(const double sorted[], int count, double fraction) {
+    int rank = (int)(fraction * count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+// Whether a benchmark passes --filter
+static bool selected(const char *name) {
+    return options.filter == NULL || strncmp(name, options.filter, strlen(options.filter)) == 0;
+}
+
+// Writes one result: throughput of the median batch (steadier across runs than the mean), latency
+// per item from the batch percentiles
+static void emit(bench_result_t *result) {
+    qsort(result->ns, (size_t)result->samples, sizeof(double), compare_doubles);
+    double per_item = (double)(result->items > 0 ? result->items : 1);
+    double p50 = percentile(result->ns, result->samples, 0.50) / per_item;
+    double rate = (p50 > 0) ? 1e9 / p50 : 0;
+    double p90 = percentile(result->ns, result->samples, 0.90) / per_item;
+    double p99 = percentile(result->ns, result->samples, 0.99) / per_item;
+    double max = result->ns[result->samples - 1] / per_item;
+    long rss = peak_rss_kb();
+
+    fprintf(options.json, "{\"bench\":\"%s\",\"revision\":\"%s\",\"items\":%lld,\"samples\":%d,"
+                          "\"items_per_sec\":%.1f,\"p50_ns\":%.2f,\"p90_ns\":%.2f,\"p99_ns\":%.2f,\"max_ns\":%.2f,"
+                          "\"bytes\":%zu,\"peak_rss_kb\":%ld}\n",
+            result->name, HARNESS_REVISION, result->items, result->samples, rate, p50, p90, p99, max,
+            result->bytes, rss);
+    if (options.json != stdout) {
+        printf("%-28s %14.0f %10.2f %10.2f %10.2f %12zu\n", result->name, rate, p50, p99, max, result->bytes);
+    }
+}
+
+// --- OUTPUT SILENCING --- //
+// The demo-facing calls (reshape, insert_element, ...) report on stdout; checks and benchmarks
+// route it to /dev/null while they run
+static int silenced_fd = -1;
+
+static void silence_begin(void) {
+    fflush(stdout);
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd == -1) {
+        return;
+    }
+    silenced_fd = dup(STDOUT_FILENO);
+    dup2(null_fd, STDOUT_FILENO);
+    close(null_fd);
+}
+
+static void silence_end(void) {
+    if (silenced_fd == -1) {
+        return;
+    }
+    fflush(stdout);
+    dup2(silenced_fd, STDOUT_FILENO);
+    close(silenced_fd);
+    silenced_fd = -1;
+}
+
+// --- SCRATCH FILES --- //
+// Creates an empty scratch file under $TMPDIR (or /tmp); fills path and returns its descriptor, or -1
+static int scratch_open(char path[], size_t size) {
+    const char *dir = getenv("TMPDIR");
+    snprintf(path, size, "%s/harness-XXXXXX", (dir != NULL && dir[0] != '\0') ? dir : "/tmp");
+    return mkstemp(path);
+}
+
+// Writes text to a new scratch file named in path; returns false if it cannot be written
+static bool scratch_write(char path[], size_t size, const char *text) {
+    int fd = scratch_open(path, size);
+    if (fd == -1) {
+        return false;
+    }
+    size_t length = strlen(text);
+    bool ok = write(fd, text, length) == (ssize_t)length;
+    close(fd);
+    if (!ok) {
+        unlink(path);
+    }
+    return ok;
+}
+
+// Reads fd from the start into a NUL-terminated buffer; NULL on failure
+static char *read_all(int fd) {
+    off_t size = lseek(fd, 0, SEEK_END);
+    char *text = (size >= 0) ? malloc((size_t)size + 1) : NULL;
+    if (text == NULL || pread(fd, text, (size_t)size, 0) != (ssize_t)size) {
+        free(text);
+        return NULL;
+    }
+    text[size] = '\0';
+    return text;
+}
+
+// Like silence_begin, but stdout goes to an unlinked scratch file that capture_end reads back
+static int captured_fd = -1;
+
+static void capture_begin(void) {
+    char path[256];
+    captured_fd = scratch_open(path, sizeof(path));
+    if (captured_fd == -1) {
+        return;
+    }
+    unlink(path);
+    fflush(stdout);
+    silenced_fd = dup(STDOUT_FILENO);
+    dup2(captured_fd, STDOUT_FILENO);
+}
+
+// Everything written to stdout since capture_begin; NULL on failure
+static char *capture_end(void) {
+    if (captured_fd == -1) {
+        return NULL;
+    }
+    silence_end();
+    char *text = read_all(captured_fd);
+    close(captured_fd);
+    captured_fd = -1;
+    return text;
+}
+
+// Timing summaries some calls print on stderr are hidden the same way
+static int quieted_fd = -1;
+
+static void quiet_stderr_begin(void) {
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd == -1) {
+        return;
+    }
+    quieted_fd = dup(STDERR_FILENO);
+    dup2(null_fd, STDERR_FILENO);
+    close(null_fd);
+}
+
+static void quiet_stderr_end(void) {
+    if (quieted_fd == -1) {
+        return;
+    }
+    dup2(quieted_fd, STDERR_FILENO);
+    close(quieted_fd);
+    quieted_fd = -1;
+}
+
+// --- SYNTHETIC DATA --- //
+// Small xorshift generator so every run uses the same inputs
+static unsigned int harness_rand(unsigned int *state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+// count values in [0, range)
+static int *gen_ints(int count, unsigned int range, unsigned int seed) {
+    int *values = malloc((size_t)count * sizeof(int));
+    for (int i = 0; values != NULL && i < count; i++) {
+        values[i] = (int)(harness_rand(&seed) % range);
+    }
+    return values;
+}
+
+// Transaction amounts as the terminal reads them: mostly small deposits and withdrawals, with a
+// share large enough to be declined
+static int *gen_transactions(int count, unsigned int seed) {
+    int *txns = malloc((size_t)count * sizeof(int));
+    for (int i = 0; txns != NULL && i < count; i++) {
+        unsigned int r = harness_rand(&seed);
+        int amount = 1 + (int)(r % 500);
+        txns[i] = ((r >> 9) % 100 < 45) ? -amount * (((r >> 16) % 10 == 0) ? 20 : 1) : amount;
+    }
+    return txns;
+}
+
+// The same amounts spread over a number of accounts
+static account_txn_t *gen_account_txns(const int txns[], int count, int accounts, unsigned int seed) {
+    account_txn_t *out = malloc((size_t)count * sizeof(account_txn_t));
+    for (int i = 0; out != NULL && i < count; i++) {
+        out[i].account_id = (int)(harness_rand(&seed) % (unsigned int)accounts);
+        out[i].amount = txns[i];
+    }
+    return out;
+}
+
+// Transactions as text, one per line, the way a stream or a file delivers them
+static char *gen_transaction_text(const int txns[], int count, size_t *length) {
+    char *text = malloc((size_t)count * 8 + 1);
+    size_t used = 0;
+    for (int i = 0; text != NULL && i < count; i++) {
+        used += (size_t)sprintf(text + used, "%d\n", txns[i]);
+    }
+    *length = used;
+    return text;
+}
+
+// Synthetic player number serial: unique name, kit number by squad slot, valid age today
+static void gen_player(player_t *player, int club, int serial, int squad_slot, unsigned int *rng) {
+    static const char *first_names[] = {"Ali", "Omar", "Yusuf", "Karim", "Sami", "Tariq", "Hadi", "Rami"};
+    static const char *last_names[] = {"Haddad", "Nasser", "Saleh", "Khalil", "Mansour", "Aziz", "Farah", "Jaber"};
+    unsigned int r = harness_rand(rng);
+    snprintf(player->name, sizeof(player->name), "%s %s %d", first_names[r % 8], last_names[(r >> 3) % 8], serial);
+    player->kit_number = KIT_MIN + squad_slot;
+    player->club = club;
+    player->dob.day = 1 + (int)((r >> 6) % 28);
+    player->dob.month = 1 + (int)((r >> 11) % 12);
+    player->dob.year = today.year - 1 - (AGE_MIN + (int)((r >> 15) % (AGE_MAX - AGE_MIN))); // Turns this age or one more this year
+    player->position = -1;
+}
+
+// A league roster of full squads; returns NULL if memory runs out
+static league_t *gen_roster(int player_count, unsigned int seed) {
+    static const char *positions[] = {"Goalkeeper", "Defender", "Midfielder", "Forward"};
+    league_t *roster = calloc(1, sizeof(league_t));
+    if (roster == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < player_count; i++) {
+        player_t player;
+        char club_name[21];
+        snprintf(club_name, sizeof(club_name), "Club %d", i / SQUAD_SIZE);
+        if (i % SQUAD_SIZE == 0 && league_add_club(roster, club_name) == -1) {
+            break;
+        }
+        gen_player(&player, roster->club_count - 1, i, i % SQUAD_SIZE, &seed);
+        player.position = league_intern_position(roster, positions[seed % 4]);
+        if (player.position == -1 || league_add_player(roster, &player) == NO_PLAYER) {
+            break;
+        }
+    }
+    if (roster->player_count != (size_t)player_count) {
+        fprintf(stderr, "[ERROR] Out of memory building a roster of %d players.\n", player_count);
+        league_free(roster);
+        free(roster);
+        return NULL;
+    }
+    return roster;
+}
+
+static void free_roster(league_t *roster) {
+    if (roster != NULL) {
+        league_free(roster);
+        free(roster);
+    }
+}
+
+// --- CORRECTNESS CHECKS --- //
+#define CHECK(condition, what) check((condition), (what), __LINE__)
+
+static void check(bool passed, const char *what, int line) {
+    if (!passed) {
+        fprintf(stderr, "[ERROR] Check failed (line %d): %s\n", line, what);
+        check_failures++;
+    }
+}
+
+static bool same_ints(const int a[], const int b[], int count) {
+    return memcmp(a, b, (size_t)count * sizeof(int)) == 0;
+}
+
+// The shift loops behind the demo's remove and insert keep the array length: removing shifts the
+// elements in front of pos one slot right (arr[0] is left duplicated), inserting shifts them one
+// slot left (arr[0] is dropped) and stores the value at pos
+static void check_shift_semantics(void) {
+    int arr[5] = {10, 20, 30, 40, 50};
+    shift_remove(arr, 2);
+    CHECK(same_ints(arr, (int[]){10, 10, 20, 40, 50}, 5), "shift_remove(pos 2) shifts the front right");
+
+    int arr2[5] = {10, 20, 30, 40, 50};
+    shift_insert(arr2, 2, 99);
+    CHECK(same_ints(arr2, (int[]){20, 30, 99, 40, 50}, 5), "shift_insert(pos 2) shifts the front left");
+
+    int arr3[5] = {10, 20, 30, 40, 50};
+    shift_remove(arr3, 0);
+    CHECK(same_ints(arr3, (int[]){10, 20, 30, 40, 50}, 5), "shift_remove(pos 0) leaves the array as is");
+    shift_insert(arr3, 4, 7);
+    CHECK(same_ints(arr3, (int[]){20, 30, 40, 50, 7}, 5), "shift_insert(last pos) drops arr[0]");
+
+    silence_begin();
+    int arr4[5] = {10, 20, 30, 40, 50};
+    remove_element(arr4, 5, 5);
+    insert_element(arr4, 5, -1, 99);
+    insert_element(arr4, 5, 5, 99);
+    bool untouched = same_ints(arr4, (int[]){10, 20, 30, 40, 50}, 5);
+    remove_element(arr4, 5, 4);
+    silence_end();
+    CHECK(untouched, "out-of-range remove/insert leave the array unchanged");
+    CHECK(same_ints(arr4, (int[]){10, 10, 20, 30, 40}, 5), "remove_element runs the shift_remove loop");
+    CHECK(isValid(arr4, 5, 0) && isValid(arr4, 5, 4) && !isValid(arr4, 5, 5) && !isValid(arr4, 5, -1),
+          "isValid accepts exactly [0, length)");
+}
+
+// reshape fills column-major and leaves arr2d alone when the dimensions do not match
+static void check_reshape_semantics(void) {
+    int arr[6] = {1, 2, 3, 4, 5, 6};
+    int arr2d[2][3] = {{0}};
+    int tall[3][2] = {{0}};
+    int wrong[4][2] = {{-1, -1}, {-1, -1}, {-1, -1}, {-1, -1}};
+
+    silence_begin();
+    reshape(arr, 6, 2, 3, arr2d);
+    reshape(arr, 6, 3, 2, tall);
+    reshape(arr, 6, 4, 2, wrong);
+    silence_end();
+    CHECK(same_ints(&arr2d[0][0], (int[]){1, 3, 5, 2, 4, 6}, 6), "reshape to 2x3 fills column-major");
+    CHECK(same_ints(&tall[0][0], (int[]){1, 4, 2, 5, 3, 6}, 6), "reshape to 3x2 fills column-major");
+    for (int i = 0; i < 8; i++) {
+        CHECK((&wrong[0][0])[i] == -1, "reshape to incompatible dimensions writes nothing");
+    }
+
+    // A large reshape goes through the parallel copy; it must agree with the formula
+    int rows = 300, cols = 700;
+    int *flat = gen_ints(rows * cols, 1u << 30, 7);
+    int *shaped = malloc((size_t)rows * cols * sizeof(int));
+    if (flat == NULL || shaped == NULL) {
+        CHECK(false, "allocation for the large reshape");
+    } else {
+        silence_begin();
+        reshape(flat, rows * cols, rows, cols, (int (*)[cols])shaped);
+        silence_end();
+        bool ok = true;
+        for (int r = 0; r < rows && ok; r++) {
+            for (int c = 0; c < cols && ok; c++) {
+                ok = (shaped[r * cols + c] == flat[c * rows + r]);
+            }
+        }
+        CHECK(ok, "large reshape matches arr2d[r][c] = arr[c * nRows + r]");
+    }
+    free(flat);
+    free(shaped);
+}
+
+// Every transpose and duplicate strategy agrees with its naive loop
+static void check_array_kernels(void) {
+    int rows = 67, cols = 131;
+    int *mat = gen_ints(rows * cols, 1000000, 11);
+    int *expected = malloc((size_t)rows * cols * sizeof(int));
+    int *got = malloc((size_t)rows * cols * sizeof(int));
+    if (mat == NULL || expected == NULL || got == NULL) {
+        CHECK(false, "allocation for the transpose checks");
+    } else {
+        trans_matrix_naive(rows, cols, mat, expected);
+        transpose_blocked(rows, cols, mat, got);
+        CHECK(same_ints(got, expected, rows * cols), "transpose_blocked matches the naive transpose");
+        transpose_parallel(rows, cols, mat, got);
+        CHECK(same_ints(got, expected, rows * cols), "transpose_parallel matches the naive transpose");
+        memcpy(got, mat, (size_t)rows * cols * sizeof(int));
+        CHECK(transpose_inplace(rows, cols, got) && same_ints(got, expected, rows * cols),
+              "transpose_inplace matches the naive transpose");
+    }
+    free(mat);
+    free(expected);
+    free(got);
+
+    int count = 5000;
+    int *values = malloc((size_t)count * sizeof(int));
+    for (int i = 0; values != NULL && i < count; i++) {
+        values[i] = i * 3;
+    }
+    if (values == NULL) {
+        CHECK(false, "allocation for the duplicate checks");
+        return;
+    }
+    values[4000] = values[1234]; // One duplicate pair: (1234, 4000)
+    dup_strategy_t strategies[] = {DUP_HASH, DUP_RADIX, DUP_BITMAP, DUP_AUTO};
+    for (int s = 0; s < 4; s++) {
+        dup_report_t report;
+        bool ran = find_duplicates(values, count, strategies[s], &report);
+        CHECK(ran && report.found && report.first_i == 1234 && report.first_j == 4000 && report.duplicate_count == 1,
+              "find_duplicates reports the first pair and the count");
+    }
+    dup_report_t parallel;
+    CHECK(find_duplicates_parallel(values, count, &parallel) && parallel.first_i == 1234 && parallel.first_j == 4000,
+          "find_duplicates_parallel reports the first pair");
+    CHECK(found_duplicate_naive(values, count) && found_duplicate(values, count), "found_duplicate sees the pair");
+    values[4000] = -1;
+    CHECK(!found_duplicate(values, count), "found_duplicate on distinct values");
+    free(values);
+}
+
+// The parallel kernels split their input into pool-sized chunks; with several threads and a length
+// that does not divide evenly, every element must still be copied exactly once
+static void check_parallel_kernels(void) {
+    int n = CHECK_PARALLEL_LENGTH, rows = 5, cols = CHECK_PARALLEL_LENGTH / 5;
+    int *src = gen_ints(n, 1u << 30, 13);
+    int *dst = calloc((size_t)n, sizeof(int));
+    int *expected = malloc((size_t)n * sizeof(int));
+    int_seq_t seq;
+    if (src == NULL || dst == NULL || expected == NULL || !seq_init(&seq, n + 1)) {
+        CHECK(false, "allocation for the parallel checks");
+        free(src);
+        free(dst);
+        free(expected);
+        return;
+    }
+    par_set_threads(CHECK_POOL_THREADS);
+
+    par_memcpy(dst, src, (size_t)n * sizeof(int));
+    CHECK(same_ints(dst, src, n), "par_memcpy copies every element");
+
+    seq_append(&seq, src, n);
+    seq_insert(&seq, 1, -1);
+    seq_remove(&seq, 1);
+    memset(dst, 0, (size_t)n * sizeof(int));
+    seq_to_array(&seq, dst);
+    CHECK(seq_length(&seq) == n && same_ints(dst, src, n), "a sequence round trip keeps every element");
+    seq_free(&seq);
+
+    silence_begin();
+    reshape(src, rows * cols, rows, cols, (int (*)[cols])dst);
+    silence_end();
+    bool ok = true;
+    for (int r = 0; r < rows && ok; r++) {
+        for (int c = 0; c < cols && ok; c++) {
+            ok = (dst[r * cols + c] == src[c * rows + r]);
+        }
+    }
+    CHECK(ok, "parallel reshape matches arr2d[r][c] = arr[c * nRows + r]");
+
+    int_view_t flat = view_from_array(src, n);
+    view_materialize_parallel(&flat, ORDER_ROW_MAJOR, dst);
+    CHECK(same_ints(dst, src, n), "view_materialize_parallel copies a flat view whole");
+
+    trans_matrix_naive(rows, cols, src, expected);
+    transpose_parallel(rows, cols, src, dst);
+    CHECK(same_ints(dst, expected, rows * cols), "transpose_parallel matches the naive transpose");
+
+    dup_report_t serial, parallel;
+    CHECK(find_duplicates(src, n, DUP_HASH, &serial) && find_duplicates_parallel(src, n, &parallel) &&
+          serial.found == parallel.found && serial.first_i == parallel.first_i &&
+          serial.first_j == parallel.first_j && serial.duplicate_count == parallel.duplicate_count,
+          "find_duplicates_parallel matches the serial scan");
+
+    par_set_threads(0);
+    free(src);
+    free(dst);
+    free(expected);
+}
+
+// Numbers split across reads, and the balance rules of the quiet ledger path
+static void check_bank_semantics(void) {
+    const char *text = "12 -7\n345,-0 99";
+    int expected[] = {12, -7, 345, 0, 99};
+    for (size_t split = 0; split <= strlen(text); split++) {
+        num_parser_t parser = {0};
+        int out[8];
+        size_t used;
+        int count = parse_numbers(&parser, text, split, out, 8, &used);
+        count += parse_numbers(&parser, text + split, strlen(text) - split, out + count, 8 - count, &used);
+        count += parse_numbers_finish(&parser, out + count);
+        CHECK(count == 5 && same_ints(out, expected, 5), "parse_numbers survives a number split across reads");
+    }
+
+    retry_policy_t saved = retry_policy;
+    retry_policy = (retry_policy_t){RETRY_NONE, 0};
+    ledger_t ledger;
+    ledger_init(&ledger);
+    int txns[] = {500, -1600, -1200, -300, 300, -50};
+    apply_batch_quiet(&ledger, txns, 6);
+    CHECK(ledger.balance == 0, "withdrawals apply while the balance stays non-negative");
+    CHECK(ledger.failed_txns == 3 && ledger.total_deposits == 500 && ledger.total_withdrawals == 1500,
+          "a zero balance declines every later transaction, deposits included");
+    ledger_free(&ledger);
+    retry_policy = saved;
+}
+
+// Fresh ledger under a given retry policy; the command-line policy is left alone
+static void ledger_init_policy(ledger_t *ledger, retry_mode_t mode, int max_attempts) {
+    retry_policy_t saved = retry_policy;
+    retry_policy = (retry_policy_t){mode, max_attempts};
+    ledger_init(ledger);
+    retry_policy = saved;
+}
+
+// Same balance, totals and queues
+static bool same_ledger(const ledger_t *a, const ledger_t *b) {
+    return a->balance == b->balance && a->total_deposits == b->total_deposits &&
+           a->total_withdrawals == b->total_withdrawals && a->failed_txns == b->failed_txns &&
+           a->recovered_txns == b->recovered_txns && a->pending.count == b->pending.count &&
+           a->abandoned.count == b->abandoned.count;
+}
+
+// The pending queue keeps arrival order across chunks, and each retry policy settles declined
+// transactions as documented: after a deposit, in one pass at the end, or never
+static void check_retry_queue(void) {
+    pending_queue_t queue;
+    pending_init(&queue);
+    long long pushed = 0, popped = 0;
+    bool in_order = true;
+    for (int round = 0; round < 3; round++) {
+        for (int k = 0; k < PENDING_CHUNK + 7; k++, pushed++) {
+            in_order &= pending_push(&queue, (pending_entry_t){pushed, -pushed, 0});
+        }
+        pending_entry_t entry;
+        for (int k = 0; k < PENDING_CHUNK / 2 && pending_pop(&queue, &entry); k++, popped++) {
+            in_order &= (entry.txn_id == popped && entry.amount == -popped);
+        }
+    }
+    pending_cursor_t cursor = pending_cursor(&queue);
+    long long listed = popped;
+    for (const pending_entry_t *entry; (entry = pending_next(&cursor)) != NULL; listed++) {
+        in_order &= (entry->txn_id == listed);
+    }
+    CHECK(in_order && listed == pushed && queue.count == (size_t)(pushed - popped),
+          "the pending queue keeps arrival order across chunks");
+    pending_free(&queue);
+
+    ledger_t ledger;
+    int on_deposit[] = {-1500, 600, -200};
+    ledger_init_policy(&ledger, RETRY_ON_DEPOSIT, DEFAULT_MAX_RETRIES);
+    apply_batch_quiet(&ledger, on_deposit, 3);
+    ledger_finish(&ledger, NULL);
+    CHECK(ledger.balance == 100 && ledger.recovered_txns == 1 && ledger.failed_txns == 2 &&
+          ledger.pending.count == 1 && ledger.abandoned.count == 0,
+          "RETRY_ON_DEPOSIT retries a declined withdrawal after the next deposit");
+    ledger_free(&ledger);
+
+    int at_end[] = {-1500, 600};
+    ledger_init_policy(&ledger, RETRY_AT_END, DEFAULT_MAX_RETRIES);
+    apply_batch_quiet(&ledger, at_end, 2);
+    bool waited = (ledger.balance == 1600 && ledger.pending.count == 1);
+    ledger_finish(&ledger, NULL);
+    CHECK(waited && ledger.balance == 100 && ledger.recovered_txns == 1 && ledger.pending.count == 0,
+          "RETRY_AT_END retries once the input is done");
+    ledger_free(&ledger);
+
+    ledger_init_policy(&ledger, RETRY_NONE, 0);
+    apply_batch_quiet(&ledger, at_end, 2);
+    ledger_finish(&ledger, NULL);
+    CHECK(ledger.balance == 1600 && ledger.recovered_txns == 0 && ledger.pending.count == 0 &&
+          ledger.abandoned.count == 1, "RETRY_NONE sends declined transactions straight to the report");
+    ledger_free(&ledger);
+
+    int hopeless[] = {-5000, 10, 10};
+    ledger_init_policy(&ledger, RETRY_ON_DEPOSIT, 1);
+    apply_batch_quiet(&ledger, hopeless, 3);
+    CHECK(ledger.pending.count == 0 && ledger.abandoned.count == 1 && ledger.failed_txns == 1,
+          "a declined transaction is abandoned after max_attempts failed retries");
+    ledger_free(&ledger);
+
+    // The logged loop and the quiet loop settle a long stream the same way
+    int n = 100000;
+    int *txns = gen_transactions(n, 17);
+    int null_fd = open("/dev/null", O_WRONLY);
+    ledger_t quiet, logged;
+    log_writer_t log;
+    if (txns == NULL || null_fd == -1 || !log_writer_init(&log, null_fd)) {
+        CHECK(false, "allocation for the logged retry check");
+    } else {
+        ledger_init_policy(&quiet, RETRY_ON_DEPOSIT, DEFAULT_MAX_RETRIES);
+        ledger_init_policy(&logged, RETRY_ON_DEPOSIT, DEFAULT_MAX_RETRIES);
+        for (int i = 0; i < n; i += STREAM_BATCH) {
+            int count = (n - i < STREAM_BATCH) ? n - i : STREAM_BATCH;
+            apply_batch_quiet(&quiet, txns + i, count);
+            apply_batch(&logged, txns + i, count, &log);
+        }
+        ledger_finish(&quiet, NULL);
+        ledger_finish(&logged, &log);
+        log_writer_free(&log);
+        CHECK(same_ledger(&quiet, &logged) && quiet.recovered_txns > 0,
+              "logged and quiet processing retry the same transactions");
+        ledger_free(&quiet);
+        ledger_free(&logged);
+    }
+    if (null_fd != -1) {
+        close(null_fd);
+    }
+    free(txns);
+}
+
+// The text between the first from and the next to in text, or NULL
+static const char *report_section(const char *text, const char *from, const char *to, size_t *length) {
+    const char *start = (text != NULL) ? strstr(text, from) : NULL;
+    const char *stop = (start != NULL) ? strstr(start, to) : NULL;
+    *length = (stop != NULL) ? (size_t)(stop - start) : 0;
+    return stop != NULL ? start : NULL;
+}
+
+// CSV conversion keeps 64-bit amounts, the quiet and logged replays agree on them, and a replay
+// resumed from the last checkpoint reports the same ledger as a full one
+static void check_ledger_files(void) {
+    char csv[256], path[256];
+    int fd = scratch_open(path, sizeof(path));
+    if (fd == -1 || !scratch_write(csv, sizeof(csv), "amount\n-5000000000\n\n6000000000\n")) {
+        CHECK(false, "scratch files for the ledger checks");
+        if (fd != -1) {
+            close(fd);
+            unlink(path);
+        }
+        return;
+    }
+    close(fd);
+
+    retry_policy_t saved = retry_policy;
+    retry_policy = (retry_policy_t){RETRY_ON_DEPOSIT, DEFAULT_MAX_RETRIES};
+    silence_begin();
+    int status = convert_csv_ledger(csv, path);
+    silence_end();
+    unlink(csv);
+    ledger_file_t file;
+    bool opened = (status == 0 && ledger_file_open(&file, path));
+    CHECK(opened && file.header->record_count == 2 && file.records[0].amount == -5000000000LL &&
+          file.records[1].amount == 6000000000LL, "convert_csv_ledger keeps amounts beyond 32 bits");
+
+    char log_path[256];
+    int log_fd = opened ? scratch_open(log_path, sizeof(log_path)) : -1;
+    log_writer_t log;
+    if (log_fd != -1 && log_writer_init(&log, log_fd)) {
+        unlink(log_path);
+        ledger_t quiet, logged;
+        ledger_init(&quiet);
+        ledger_init(&logged);
+        quiet.balance = logged.balance = file.header->base_balance;
+        apply_records(&quiet, file.records, 2, NULL);
+        apply_records(&logged, file.records, 2, &log);
+        ledger_finish(&quiet, NULL);
+        ledger_finish(&logged, &log);
+        log_writer_free(&log);
+        char *text = read_all(log_fd);
+        CHECK(quiet.balance == BASE_BALANCE + 1000000000LL && quiet.total_deposits == 6000000000LL &&
+              quiet.total_withdrawals == 5000000000LL && quiet.recovered_txns == 1,
+              "a quiet replay applies amounts beyond 32 bits whole");
+        CHECK(same_ledger(&quiet, &logged) && text != NULL && strstr(text, "Deposit of 6000000000 AED") != NULL,
+              "a logged replay applies and logs amounts beyond 32 bits whole");
+        free(text);
+        ledger_free(&quiet);
+        ledger_free(&logged);
+    } else if (opened) {
+        CHECK(false, "log file for the replay check");
+    }
+    if (log_fd != -1) {
+        close(log_fd);
+    }
+    if (opened) {
+        ledger_file_close(&file);
+    }
+
+    // One abandoned withdrawal, then a checkpoint interval of small transactions
+    retry_policy = (retry_policy_t){RETRY_NONE, 0};
+    ledger_file_writer_t writer;
+    fd = open(path, O_WRONLY | O_TRUNC);
+    bool written = (fd != -1 && ledger_file_writer_init(&writer, fd));
+    written = written && ledger_file_writer_add(&writer, (ledger_record_t){-5000, 0, 0});
+    for (long long k = 0; written && k < LEDGER_CHECKPOINT_INTERVAL + 100; k++) {
+        written = ledger_file_writer_add(&writer, (ledger_record_t){(k % 2 == 0) ? 1 : -1, 0, 0});
+    }
+    written = written && ledger_file_writer_finish(&writer);
+    if (fd != -1) {
+        close(fd);
+    }
+    opened = written && ledger_file_open(&file, path);
+    const ledger_checkpoint_t *checkpoint = opened ? ledger_file_checkpoint(&file, &retry_policy) : NULL;
+    CHECK(checkpoint != NULL && checkpoint->record_index > LEDGER_CHECKPOINT_INTERVAL &&
+          checkpoint->abandoned_count == 1, "the ledger writer checkpoints the abandoned count");
+    if (opened) {
+        ledger_file_close(&file);
+    }
+
+    capture_begin();
+    execute_ledger_replay(path, true, false);
+    char *full = capture_end();
+    capture_begin();
+    execute_ledger_replay(path, true, true);
+    char *resumed = capture_end();
+    size_t full_length, resumed_length;
+    const char *full_summary = report_section(full, "TRANSACTION SUMMARY", "[PERF]", &full_length);
+    const char *resumed_summary = report_section(resumed, "TRANSACTION SUMMARY", "[PERF]", &resumed_length);
+    CHECK(resumed != NULL && strstr(resumed, "Resuming from checkpoint") != NULL, "--resume starts from the checkpoint");
+    CHECK(full_summary != NULL && resumed_summary != NULL && full_length == resumed_length &&
+          memcmp(full_summary, resumed_summary, full_length) == 0, "a resumed replay reports the totals of a full one");
+    CHECK(full != NULL && strstr(full, "[SUCCESS]") == NULL && strstr(resumed, "[SUCCESS]") == NULL &&
+          strstr(resumed, "[NOTICE] Some transactions remain unprocessed.") != NULL,
+          "a resumed replay still reports transactions abandoned before the checkpoint");
+    free(full);
+    free(resumed);
+    unlink(path);
+    retry_policy = saved;
+}
+
+// The log thread writes exactly the text the synchronous writer does
+static void check_async_log(void) {
+    int n = 200000;
+    int *txns = gen_transactions(n, 19);
+    char *text[2] = {NULL, NULL};
+    for (int async = 0; txns != NULL && async < 2; async++) {
+        char path[256];
+        int fd = scratch_open(path, sizeof(path));
+        if (fd == -1) {
+            break;
+        }
+        unlink(path);
+        ledger_t ledger;
+        log_writer_t log;
+        ledger_init_policy(&ledger, RETRY_ON_DEPOSIT, DEFAULT_MAX_RETRIES);
+        if (log_writer_init(&log, fd)) {
+            if (async) {
+                log_writer_start_async(&log, LOG_BLOCK);
+            }
+            for (int i = 0; i < n; i += STREAM_BATCH) {
+                apply_batch(&ledger, txns + i, (n - i < STREAM_BATCH) ? n - i : STREAM_BATCH, &log);
+            }
+            ledger_finish(&ledger, &log);
+            log_writer_free(&log);
+            text[async] = read_all(fd);
+        }
+        ledger_free(&ledger);
+        close(fd);
+    }
+    CHECK(text[0] != NULL && text[1] != NULL && text[0][0] != '\0' && strcmp(text[0], text[1]) == 0,
+          "the async log writes the same text as the synchronous one");
+    free(text[0]);
+    free(text[1]);
+    free(txns);
+}
+
+// Indexes and running statistics of a synthetic roster agree with the roster itself
+static void check_league_semantics(void) {
+    int player_count = 2000;
+    league_t *roster = gen_roster(player_count, 99);
+    if (roster == NULL) {
+        CHECK(false, "allocation for the league checks");
+        return;
+    }
+    bool found_all = true, prefix_first = true, fuzzy_found = true;
+    for (player_handle_t handle = 0; handle < (player_handle_t)player_count; handle++) {
+        const char *name = league_name(roster, handle); // Names are unique, so each one leads back here
+        name_match_t matches[4];
+        found_all &= (name_index_find(&roster->names, roster, name, -1, 0) == handle);
+        prefix_first &= (name_search_prefix(roster, name, matches, 1) == 1 && matches[0].player == handle);
+        if (handle % 97 == 0) {
+            char typo[25];
+            snprintf(typo, sizeof(typo), "%s", name);
+            memmove(typo + 1, typo + 2, strlen(typo + 1)); // Drops the second letter
+            size_t count = name_search_fuzzy(roster, typo, 1, matches, 4);
+            bool listed = false;
+            for (size_t m = 0; m < count; m++) {
+                listed |= (matches[m].player == handle);
+            }
+            fuzzy_found &= listed;
+        }
+    }
+    CHECK(found_all, "every rostered name is found by the name index");
+    CHECK(prefix_first, "a full-name prefix search returns the player first");
+    CHECK(fuzzy_found, "fuzzy search tolerates a dropped letter");
+
+    league_stats_t running, scanned;
+    if (league_compute_stats(roster, today.year, &running) && league_scan_stats(roster, today.year, &scanned)) {
+        bool same = running.club_count == scanned.club_count && running.total_age == scanned.total_age &&
+                    running.min_age_all == scanned.min_age_all && running.max_age_all == scanned.max_age_all &&
+                    memcmp(running.age_histogram, scanned.age_histogram, sizeof(running.age_histogram)) == 0;
+        for (int c = 0; same && c < running.club_count; c++) {
+            same = running.age_sum[c] == scanned.age_sum[c];
+        }
+        CHECK(same, "running statistics match a full scan");
+
+        // The statistics screens and the player listings have to agree on every age
+        long long listed_sum = 0;
+        for (player_handle_t handle = 0; handle < (player_handle_t)player_count; handle++) {
+            listed_sum += league_age(roster, handle);
+        }
+        CHECK(running.total_age == listed_sum, "running statistics use the exact ages players are listed with");
+        league_stats_free(&running);
+        league_stats_free(&scanned);
+    } else {
+        CHECK(false, "allocation for the league statistics");
+    }
+    free_roster(roster);
+}
+
+// The bulk import applies the add_player rules row by row, and a snapshot loads back the league it
+// was saved from
+static void check_league_files(void) {
+    int year = today.year - AGE_MIN - 1;  // Born on 1 January: AGE_MIN + 1 years old today
+    char text[1024], path[256];
+    snprintf(text, sizeof(text),
+             "club,name,kit_number,position,day,month,year\n"
+             "Alpha\n"
+             "Alpha,Ann Lee,%d,Forward,1,1,%d\n"
+             "Alpha,Bob Ray,%d,Defender,1,1,%d\n"
+             "Alpha,Ann Lee,%d,Defender,1,1,%d\n"
+             "Alpha,Cid Moe,%d,Forward,1,1,%d\n"
+             "Alpha,Dee Fox,%d,Forward,1,1,%d\n"
+             "Alpha,Eve Kim,%d,Forward,31,2,%d\n"
+             "Beta,Ann Lee,%d,Goalkeeper,1,1,%d\n"
+             "Alpha,Too Few\n"
+             "Alpha,A name far longer than the limit,%d,Forward,1,1,%d\n",
+             KIT_MIN, year, KIT_MIN, year, KIT_MIN + 1, year, KIT_MAX + 1, year,
+             KIT_MIN + 1, today.year - AGE_MAX - 5, KIT_MIN + 1, year, KIT_MIN, year, KIT_MIN + 1, year);
+    league_t *imported = calloc(1, sizeof(league_t));
+    if (imported == NULL || !scratch_write(path, sizeof(path), text)) {
+        CHECK(false, "scratch file for the import check");
+        free(imported);
+        return;
+    }
+    import_report_t report;
+    silence_begin();
+    int ok = league_import_csv(imported, path, &report);
+    silence_end();
+    unlink(path);
+    CHECK(ok && report.lines == 11 && report.clubs_added == 2 && report.players_added == 2 && report.rejected == 7,
+          "league_import_csv rejects duplicate, kit, age, date, length and field-count violations");
+    CHECK(imported->player_count == 2 && league_find_club(imported, "Beta") == 1 &&
+          league_age(imported, 0) == AGE_MIN + 1, "imported rows keep their club and age");
+    free_roster(imported);
+
+    int player_count = 1500;
+    league_t *roster = gen_roster(player_count, 31);
+    league_t *loaded = calloc(1, sizeof(league_t));
+    int fd = scratch_open(path, sizeof(path));
+    if (roster == NULL || loaded == NULL || fd == -1) {
+        CHECK(false, "allocation for the snapshot check");
+        free_roster(roster);
+        free(loaded);
+        if (fd != -1) {
+            close(fd);
+            unlink(path);
+        }
+        return;
+    }
+    close(fd);
+    silence_begin();
+    ok = league_save_snapshot(roster, path) && league_load_snapshot(loaded, path);
+    silence_end();
+    bool same = ok && loaded->player_count == roster->player_count && loaded->club_count == roster->club_count;
+    for (player_handle_t handle = 0; same && handle < (player_handle_t)player_count; handle++) {
+        const char *name = league_name(roster, handle);
+        same = strcmp(league_name(loaded, handle), name) == 0 &&
+               league_age(loaded, handle) == league_age(roster, handle) &&
+               loaded->kit_number[handle] == roster->kit_number[handle] &&
+               loaded->club_id[handle] == roster->club_id[handle] &&
+               strcmp(loaded->positions[loaded->position_id[handle]], roster->positions[roster->position_id[handle]]) == 0 &&
+               name_index_find(&loaded->names, loaded, name, -1, 0) == handle;
+    }
+    CHECK(same, "a snapshot loads back every player, with a working name index");
+    league_stats_t before, after;
+    if (same && league_compute_stats(roster, today.year, &before) && league_compute_stats(loaded, today.year, &after)) {
+        CHECK(before.total_age == after.total_age && before.min_age_all == after.min_age_all &&
+              before.max_age_all == after.max_age_all, "a loaded snapshot keeps the running statistics");
+        league_stats_free(&before);
+        league_stats_free(&after);
+    }
+
+    // A cut-off snapshot is refused and leaves the league alone
+    ok = truncate(path, 4096) == 0;
+    silence_begin();
+    ok = ok && !league_load_snapshot(loaded, path);
+    silence_end();
+    CHECK(ok && loaded->player_count == (size_t)player_count, "a truncated snapshot is refused");
+    unlink(path);
+    free_roster(roster);
+    free_roster(loaded);
+}
+
+// Batch commands print one tab-separated result line each, errors carrying the input line number
+static void check_batch_output(void) {
+    int year = today.year - AGE_MIN - 1, age = AGE_MIN + 1;
+    char commands[1024], expected[2048], path[256];
+    snprintf(commands, sizeof(commands),
+             "enroll,Alpha\n"
+             "enroll,Alpha\n"
+             "add,Alpha,Ann Lee,%d,Forward,1,1,%d\n"
+             "add,Alpha,Bob Ray,%d,Defender,1,1,%d\n"
+             "\n"
+             "# lookups\n"
+             "find-name,ann lee\n"
+             "find-kit,%d\n"
+             "update-position,Ann Lee,Defender\n"
+             "stats,Alpha\n"
+             "stats\n"
+             "find-name,Nobody\n"
+             "bogus\n",
+             KIT_MIN, year, KIT_MIN, year, KIT_MIN);
+    snprintf(expected, sizeof(expected),
+             "ok\tenroll\t1\tAlpha\n"
+             "error\tenroll\t2\tClub is already enrolled.\n"
+             "ok\tadd\tAlpha\tAnn Lee\t%d\n"
+             "error\tadd\t4\tDuplicate entry detected! Player name or kit number must be unique.\n"
+             "ok\tfind-name\tAlpha\tAnn Lee\t%d\tForward\t%d\n"
+             "ok\tfind-kit\tAlpha\tAnn Lee\t%d\tForward\t%d\n"
+             "ok\tupdate-position\tAlpha\tAnn Lee\t%d\tDefender\t%d\n"
+             "ok\tstats\tAlpha\t1\t%d.00\t%d\t%d\n"
+             "ok\tstats\t1\t1\t%d.00\t%d\t%d\n"
+             "error\tfind-name\t12\tPlayer not found.\n"
+             "error\tbogus\t13\tUnknown command.\n",
+             KIT_MIN, KIT_MIN, age, KIT_MIN, age, KIT_MIN, age, age, age, age, age, age, age);
+    if (!scratch_write(path, sizeof(path), commands)) {
+        CHECK(false, "scratch file for the batch check");
+        return;
+    }
+    quiet_stderr_begin();
+    capture_begin();
+    int ok = run_batch(path);
+    char *output = capture_end();
+    quiet_stderr_end();
+    unlink(path);
+    CHECK(ok && output != NULL && strcmp(output, expected) == 0, "run_batch prints the documented result lines");
+    free(output);
+    league_free(&league);
+}
+
+static void run_checks(void) {
+    check_shift_semantics();
+    check_reshape_semantics();
+    check_array_kernels();
+    check_parallel_kernels();
+    check_bank_semantics();
+    check_retry_queue();
+    check_ledger_files();
+    check_async_log();
+    check_league_semantics();
+    check_league_files();
+    check_batch_output();
+    fprintf(stderr, "[INFO] Correctness checks: %s\n", check_failures == 0 ? "all passed" : "FAILED");
+}
+
+// --- ARRAY BENCHMARKS --- //
+static void bench_array(void) {
+    int n = options.quick ? 100000 : 1000000;
+    int samples = options.quick ? 5 : 15;
+
+    // Positional edits: the demo's shift loops against the gap buffer
+    int edits = 200;
+    int *arr = gen_ints(n, 1000000, 1);
+    int *positions = gen_ints(edits, (unsigned int)n, 2);
+    int_seq_t seq;
+    if (arr != NULL && positions != NULL && selected("array.shift_insert")) {
+        bench_result_t result = {"array.shift_insert", edits, samples, {0}, (size_t)n * sizeof(int)};
+        for (int s = 0; s < samples; s++) {
+            double start = now_ns();
+            for (int e = 0; e < edits; e++) {
+                shift_insert(arr, positions[e], e);
+            }
+            result.ns[s] = now_ns() - start;
+        }
+        emit(&result);
+    }
+    if (arr != NULL && positions != NULL && selected("array.seq_insert") && seq_init(&seq, n + edits * samples)) {
+        seq_append(&seq, arr, n);
+        bench_result_t result = {"array.seq_insert", edits, samples, {0}, (size_t)seq.capacity * sizeof(int)};
+        for (int s = 0; s < samples; s++) {
+            double start = now_ns();
+            for (int e = 0; e < edits; e++) {
+                seq_insert(&seq, positions[e], e);
+            }
+            result.ns[s] = now_ns() - start;
+        }
+        seq_free(&seq);
+        emit(&result);
+    }
+    free(positions);
+
+    // Matrix kernels over a square-ish matrix with ragged edges
+    int rows = options.quick ? 500 : 1500, cols = options.quick ? 600 : 1700;
+    int *mat = gen_ints(rows * cols, 1000000, 3);
+    int *out = malloc((size_t)rows * cols * sizeof(int));
+    size_t bytes = 2 * (size_t)rows * cols * sizeof(int);
+    if (mat != NULL && out != NULL) {
+        struct { const char *name; void (*kernel)(int, int, const int *, int *); } kernels[] = {
+            {"array.transpose_naive", trans_matrix_naive},
+            {"array.transpose_blocked", transpose_blocked},
+            {"array.transpose_parallel", transpose_parallel},
+        };
+        for (int k = 0; k < 3; k++) {
+            if (!selected(kernels[k].name)) {
+                continue;
+            }
+            bench_result_t result = {kernels[k].name, (long long)rows * cols, samples, {0}, bytes};
+            for (int s = 0; s < samples; s++) {
+                double start = now_ns();
+                kernels[k].kernel(rows, cols, mat, out);
+                result.ns[s] = now_ns() - start;
+            }
+            emit(&result);
+        }
+        if (selected("array.reshape")) {
+            bench_result_t result = {"array.reshape", (long long)rows * cols, samples, {0}, bytes};
+            silence_begin();
+            for (int s = 0; s < samples; s++) {
+                double start = now_ns();
+                reshape(mat, rows * cols, rows, cols, (int (*)[cols])out);
+                result.ns[s] = now_ns() - start;
+            }
+            silence_end();
+            emit(&result);
+        }
+    }
+    free(mat);
+    free(out);
+
+    // Duplicate scans over distinct values, so every strategy reads the whole input
+    for (int i = 0; arr != NULL && i < n; i++) {
+        arr[i] = i * 7;
+    }
+    struct { const char *name; dup_strategy_t strategy; } scans[] = {
+        {"array.dup_hash", DUP_HASH}, {"array.dup_radix", DUP_RADIX}, {"array.dup_bitmap", DUP_BITMAP},
+    };
+    for (int k = 0; arr != NULL && k < 3; k++) {
+        if (!selected(scans[k].name)) {
+            continue;
+        }
+        bench_result_t result = {scans[k].name, n, samples, {0}, (size_t)n * sizeof(int)};
+        for (int s = 0; s < samples; s++) {
+            dup_report_t report;
+            double start = now_ns();
+            find_duplicates(arr, n, scans[k].strategy, &report);
+            result.ns[s] = now_ns() - start;
+        }
+        emit(&result);
+    }
+    free(arr);
+}
+
+// --- BANK TERMINAL BENCHMARKS --- //
+static void bench_bank(void) {
+    int n = options.quick ? 200000 : 2000000;
+    int samples = options.quick ? 5 : 15;
+    int *txns = gen_transactions(n, 4);
+    if (txns == NULL) {
+        fprintf(stderr, "[ERROR] Out of memory generating %d transactions.\n", n);
+        return;
+    }
+
+    size_t length;
+    char *text = gen_transaction_text(txns, n, &length);
+    int *parsed = malloc((size_t)n * sizeof(int));
+    if (text != NULL && parsed != NULL && selected("bank.parse_numbers")) {
+        bench_result_t result = {"bank.parse_numbers", n, samples, {0}, length + (size_t)n * sizeof(int)};
+        for (int s = 0; s < samples; s++) {
+            num_parser_t parser = {0};
+            size_t used;
+            double start = now_ns();
+            int count = parse_numbers(&parser, text, length, parsed, n, &used);
+            parse_numbers_finish(&parser, parsed + count);
+            result.ns[s] = now_ns() - start;
+        }
+        emit(&result);
+    }
+    free(text);
+    free(parsed);
+
+    // A fresh ledger per pass, in batches the size the streaming path applies
+    if (selected("bank.apply_batch")) {
+        bench_result_t result = {"bank.apply_batch", n, samples, {0}, (size_t)n * sizeof(int)};
+        for (int s = 0; s < samples; s++) {
+            ledger_t ledger;
+            ledger_init(&ledger);
+            double start = now_ns();
+            for (int i = 0; i < n; i += STREAM_BATCH) {
+                apply_batch_quiet(&ledger, txns + i, (n - i < STREAM_BATCH) ? n - i : STREAM_BATCH);
+            }
+            result.ns[s] = now_ns() - start;
+            ledger_free(&ledger);
+        }
+        emit(&result);
+    }
+
+    account_txn_t *accounts = gen_account_txns(txns, n, 10000, 5);
+    sharded_ledger_t sharded;
+    if (accounts != NULL && selected("bank.sharded_apply") && sharded_ledger_init(&sharded, 4)) {
+        bench_result_t result = {"bank.sharded_apply", n, samples, {0}, (size_t)n * sizeof(account_txn_t)};
+        for (int s = 0; s < samples; s++) {
+            double start = now_ns();
+            sharded_ledger_apply(&sharded, accounts, n);
+            result.ns[s] = now_ns() - start;
+        }
+        sharded_ledger_free(&sharded);
+        emit(&result);
+    }
+    free(accounts);
+    free(txns);
+}
+
+// --- LEAGUE BENCHMARKS --- //
+static void bench_league(void) {
+    int player_count = options.quick ? 20000 : 200000;
+    int samples = options.quick ? 5 : 11;
+    int lookups = 1000;
+
+    // Building a roster times the whole write path: columns, name index, trigram index, tallies
+    if (selected("league.build")) {
+        bench_result_t result = {"league.build", player_count, samples, {0}, 0};
+        for (int s = 0; s < samples; s++) {
+            double start = now_ns();
+            league_t *roster = gen_roster(player_count, 6);
+            result.ns[s] = now_ns() - start;
+            if (roster == NULL) {
+                return;
+            }
+            result.bytes = league_memory(roster);
+            free_roster(roster);
+        }
+        emit(&result);
+    }
+
+    league_t *roster = gen_roster(player_count, 6);
+    if (roster == NULL) {
+        return;
+    }
+    size_t bytes = league_memory(roster);
+    char (*names)[25] = malloc((size_t)lookups * sizeof(*names));
+    unsigned int seed = 8;
+    for (int i = 0; names != NULL && i < lookups; i++) {
+        player_handle_t handle = harness_rand(&seed) % (unsigned int)player_count;
+        snprintf(names[i], sizeof(names[i]), "%s", league_name(roster, handle));
+    }
+
+    if (names != NULL && selected("league.name_lookup")) {
+        bench_result_t result = {"league.name_lookup", lookups, MAX_SAMPLES, {0}, bytes};
+        for (int s = 0; s < MAX_SAMPLES; s++) {
+            double start = now_ns();
+            for (int i = 0; i < lookups; i++) {
+                name_index_find(&roster->names, roster, names[i], -1, 0);
+            }
+            result.ns[s] = now_ns() - start;
+        }
+        emit(&result);
+    }
+
+    // Prefix queries on the first name and a few letters of the last, fuzzy ones with a typo
+    name_match_t matches[10];
+    int queries = 100;
+    if (names != NULL && selected("league.prefix_search")) {
+        bench_result_t result = {"league.prefix_search", queries, samples * 3, {0}, bytes};
+        for (int s = 0; s < result.samples; s++) {
+            double start = now_ns();
+            for (int i = 0; i < queries; i++) {
+                char prefix[25];
+                snprintf(prefix, sizeof(prefix), "%.*s", (int)strcspn(names[i], " ") + 4, names[i]);
+                name_search_prefix(roster, prefix, matches, 10);
+            }
+            result.ns[s] = now_ns() - start;
+        }
+        emit(&result);
+    }
+    if (names != NULL && selected("league.fuzzy_search")) {
+        bench_result_t result = {"league.fuzzy_search", queries, samples, {0}, bytes};
+        for (int s = 0; s < samples; s++) {
+            double start = now_ns();
+            for (int i = 0; i < queries; i++) {
+                char query[25];
+                snprintf(query, sizeof(query), "%s", names[i]);
+                query[1] = 'x';
+                name_search_fuzzy(roster, query, 1, matches, 10);
+            }
+            result.ns[s] = now_ns() - start;
+        }
+        emit(&result);
+    }
+    free(names);
+
+    struct { const char *name; int (*stats)(const league_t *, int, league_stats_t *); } views[] = {
+        {"league.stats_running", league_compute_stats}, {"league.stats_scan", league_scan_stats},
+    };
+    for (int k = 0; k < 2; k++) {
+        if (!selected(views[k].name)) {
+            continue;
+        }
+        bench_result_t result = {views[k].name, player_count, samples, {0}, bytes};
+        for (int s = 0; s < samples; s++) {
+            league_stats_t stats;
+            double start = now_ns();
+            int ok = views[k].stats(roster, today.year, &stats);
+            result.ns[s] = now_ns() - start;
+            if (ok) {
+                league_stats_free(&stats);
+            }
+        }
+        emit(&result);
+    }
+    free_roster(roster);
+}
+
+// --- REGRESSION COMPARISON --- //
+// Reads the JSON lines of a harness run; returns the number of entries, or -1 if the file cannot be read
+static int read_results(const char *path, compare_entry_t entries[], int max) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "[ERROR] Unable to open %s.\n", path);
+        return -1;
+    }
+    char line[1024];
+    int count = 0;
+    while (count < max && fgets(line, sizeof(line), file) != NULL) {
+        const char *name = strstr(line, "\"bench\":\"");
+        const char *rate = strstr(line, "\"items_per_sec\":");
+        const char *p99 = strstr(line, "\"p99_ns\":");
+        if (name == NULL || rate == NULL || p99 == NULL) {
+            continue;
+        }
+        name += strlen("\"bench\":\"");
+        int length = (int)strcspn(name, "\"");
+        snprintf(entries[count].name, sizeof(entries[count].name), "%.*s", length, name);
+        entries[count].items_per_sec = strtod(rate + strlen("\"items_per_sec\":"), NULL);
+        entries[count].p99_ns = strtod(p99 + strlen("\"p99_ns\":"), NULL);
+        count++;
+    }
+    fclose(file);
+    return count;
+}
+
+// Compares two runs benchmark by benchmark; a throughput drop beyond tolerance is a regression.
+// Returns the exit status: 0 if nothing regressed, 1 otherwise.
+static int compare_runs(const char *base_path, const char *new_path, double tolerance) {
+    static compare_entry_t base[MAX_RESULTS], next[MAX_RESULTS];
+    int base_count = read_results(base_path, base, MAX_RESULTS);
+    int next_count = read_results(new_path, next, MAX_RESULTS);
+    if (base_count < 0 || next_count < 0) {
+        return 1;
+    }
+
+    int regressions = 0;
+    printf("%-28s %14s %14s %9s %11s %11s\n", "benchmark", "base items/s", "new items/s", "change", "base p99", "new p99");
+    for (int i = 0; i < next_count; i++) {
+        int j = 0;
+        while (j < base_count && strcmp(base[j].name, next[i].name) != 0) {
+            j++;
+        }
+        if (j == base_count) {
+            printf("%-28s %14s %14.0f %9s\n", next[i].name, "-", next[i].items_per_sec, "new");
+            continue;
+        }
+        double change = (base[j].items_per_sec > 0) ? next[i].items_per_sec / base[j].items_per_sec - 1 : 0;
+        bool regressed = change < -tolerance;
+        regressions += regressed;
+        printf("%-28s %14.0f %14.0f %+8.1f%% %11.2f %11.2f%s\n", next[i].name, base[j].items_per_sec,
+               next[i].items_per_sec, change * 100, base[j].p99_ns, next[i].p99_ns, regressed ? "  REGRESSION" : "");
+    }
+    if (regressions > 0) {
+        printf("[ERROR] %d benchmark(s) lost more than %.0f%% throughput.\n", regressions, tolerance * 100);
+    } else {
+        printf("[INFO] No regression beyond %.0f%%.\n", tolerance * 100);
+    }
+    return regressions > 0;
+}
+
+// --- MAIN FUNCTION --- //
+int main(int argc, char *argv[]) {
+    bool check_only = false;
+    const char *json_path = NULL;
+    options.json = stdout;
+
+    if (argc >= 4 && strcmp(argv[1], "--compare") == 0) {
+        double tolerance = DEFAULT_TOLERANCE;
+        if (argc >= 6 && strcmp(argv[4], "--tolerance") == 0) {
+            tolerance = atof(argv[5]);
+        }
+        return compare_runs(argv[2], argv[3], tolerance);
+    }
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            options.quick = true;
+        } else if (strcmp(argv[i], "--check-only") == 0) {
+            check_only = true;
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            json_path = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [--quick] [--filter PREFIX] [--json FILE] [--check-only]\n"
+                            "       %s --compare BASE.json NEW.json [--tolerance FRACTION]\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+
+    today = current_date();
+    par_set_threads(0);
+    run_checks();
+    if (check_failures > 0 || check_only) {
+        return check_failures > 0;
+    }
+
+    if (json_path != NULL) {
+        options.json = fopen(json_path, "w");
+        if (options.json == NULL) {
+            fprintf(stderr, "[ERROR] Unable to write %s.\n", json_path);
+            return 1;
+        }
+        printf("%-28s %14s %10s %10s %10s %12s\n", "benchmark", "items/s", "p50 ns", "p99 ns", "max ns", "bytes");
+    }
+    bench_array();
+    bench_bank();
+    bench_league();
+    if (options.json != stdout) {
+        fclose(options.json);
+    }
+    return 0;
+}
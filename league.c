@@ -0,0 +1,2840 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <time.h>
+#include <errno.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "league.h"
+
+// --- GLOBAL VARIABLES --- //
+league_t league;              // The league being managed
+age_t today;                  // Date ages are counted on, read at startup; fixed for the run, as the running statistics count birthdays against it
+
+// --- DISPLAY MAIN MENU --- //
+void display_menu() {
+    printf("\n==== LEAGUE SYSTEM CONTROL PANEL ===\n");
+    printf(" [1] Enroll New Club            \n");
+    printf(" [2] Add Player to Club         \n");
+    printf(" [3] Search & Update Player     \n");
+    printf(" [4] Display Statistics         \n");
+    printf(" [5] Exit System                \n");
+    printf(" [6] Display Summary Only       \n");
+    printf("====================================\n");
+    printf("[SYS] Choose your option: ");
+}
+
+// --- ENROLL A NEW CLUB --- //
+void enroll_club() {
+    // The club limit is a league rule; storage itself grows as needed
+    if (league.club_count >= NUM_TEAMS) {
+        handle_error("Club limit reached. Enrollment not possible.");
+        return;
+    }
+
+    char name[256];
+    printf("> [SYSTEM] Enter the club name (MAX CHAR 20): ");
+    scanf(" %255[^\n]", name);
+
+    // Enforces character limit for a clubs name
+    if (strlen(name) > 20) {
+        handle_error("[ALERT] Club name exceeds Max Char Limit (20). Please revise your entry.");
+        return;
+    }
+
+    int club_index = league_add_club(&league, name);
+    if (club_index == -1) {
+        handle_error("Out of memory. Club could not be enrolled.");
+        return;
+    }
+    printf(">> [STATUS UPDATE] Club '%s' has been successfully enrolled in the system.\n", league.clubs[club_index].name);
+}
+
+// --- ADD PLAYER TO CLUB --- //
+void add_player() {
+    if (league.club_count == 0) {
+        handle_error("No clubs detected! Enroll a club to proceed.");
+        return;
+    }
+
+    int club_index = get_club_index(); // Asks the user to select a valid club
+    if (club_index == -1) return;     // Exits if the club selection fails
+
+    // Squad size is a league rule; storage itself is not limited per club
+    if (league.clubs[club_index].active_size >= SQUAD_SIZE) {
+        handle_error("Team capacity exceeded. No more players can be added.");
+        return;
+    }
+
+    player_t new_player;
+    char position[20];
+    new_player.club = club_index;
+
+    printf("> [ACTION] Enter player's full name: ");
+    scanf(" %24[^\n]", new_player.name);
+
+    printf("> [ACTION] Enter kit number (%d-%d): ", KIT_MIN, KIT_MAX);
+    if (scanf("%d", &new_player.kit_number) != 1 || !validate_kit_number(new_player.kit_number)) {
+        handle_error(KIT_RULE);
+        return;
+    }
+
+    printf("> [ACTION] Enter position: ");
+    scanf(" %19[^\n]", position);
+
+    printf("> [ACTION] Enter date of birth (dd mm yyyy): ");
+    if (scanf("%d %d %d", &new_player.dob.day, &new_player.dob.month, &new_player.dob.year) != 3 ||
+        !validate_age(&new_player.dob)) {
+        handle_error(AGE_RULE);
+        return;
+    }
+
+    // Checks for duplicates through the kit bitmap and the name index
+    team_t *team = &league.clubs[club_index];
+    if (team_has_kit(team, new_player.kit_number) ||
+        name_index_find(&league.names, &league, new_player.name, club_index, 1) != NO_PLAYER) {
+        handle_error("Duplicate entry detected! Player name or kit number must be unique.");
+        return;
+    }
+
+    // Adds a player to the club, which also makes it findable by name and kit number
+    new_player.position = league_intern_position(&league, position);
+    if (new_player.position == -1 || league_add_player(&league, &new_player) == NO_PLAYER) {
+        handle_error("Out of memory. Player could not be added.");
+        return;
+    }
+    printf(">> [STATUS UPDATE] Player '%s' added to '%s'.\n", new_player.name, team->name);
+}
+
+// --- GET VALID CLUB INDEX --- //
+int get_club_index() {
+    int choice;
+    printf("\n========== SELECT A CLUB ==========\n");
+    for (int i = 0; i < league.club_count; i++) {
+        printf("[%d] %s\n", i + 1, league.clubs[i].name);
+    }
+    printf("===================================\n");
+    printf("> [ACTION] Choose a club by number: ");
+    if (scanf("%d", &choice) != 1 || choice < 1 || choice > league.club_count) {
+        while (getchar() != '\n'); // Clears the invalid input
+        handle_error("Invalid selection! Please choose a valid club to proceed.");
+        return -1;
+    }
+    return choice - 1; // Returns a valid club index
+}
+
+// --- CURRENT DATE --- //
+age_t current_date() {
+    time_t now = time(NULL);
+    struct tm local;
+    localtime_r(&now, &local);
+    return (age_t){local.tm_mday, local.tm_mon + 1, local.tm_year + 1900};
+}
+
+// --- AGE ON A DATE --- //
+// Whole years, counting the birthday itself
+int age_on(const age_t *dob, const age_t *date) {
+    int age = date->year - dob->year;
+    if (date->month < dob->month || (date->month == dob->month && date->day < dob->day)) {
+        age--;
+    }
+    return age;
+}
+
+// Birth year as the running statistics count it: a player whose birthday is still ahead of today's
+// month and day counts as born a year later, so a year minus it is the exact age on that day
+static int birth_cohort(int year, int month, int day) {
+    return year + (month * 32 + day > today.month * 32 + today.day);
+}
+
+// --- ERROR HANDLING --- //
+void handle_error(const char *message) {
+    printf("[ERROR] %s\n", message);
+}
+
+// --- SEARCH AND UPDATE PLAYER DETAILS --- //
+void search_update() {
+    if (league.club_count == 0) {
+        handle_error("No clubs identified! Please enroll a club first.");
+        return;
+    }
+
+    printf("\n========== SEARCH PLAYER ==========\n");
+    printf("[1] Search by Name\n");
+    printf("[2] Search by Kit Number\n");
+    printf("===================================\n");
+    printf("> [ACTION] Choose a search option: ");
+
+    int search_option;
+    if (scanf("%d", &search_option) != 1 || (search_option != 1 && search_option != 2)) {
+        while (getchar() != '\n'); // Clears the invalid input
+        handle_error("Invalid selection! Please choose either option 1 or option 2.");
+        return;
+    }
+
+    if (search_option == 1) {
+        char search_name[25];
+        printf("> [ACTION] Enter player name to search: ");
+        scanf(" %[^\n]", search_name);
+
+        player_handle_t found = name_index_find(&league.names, &league, search_name, -1, 0);
+        if (found != NO_PLAYER) {
+            update_player_position(found);
+            return;
+        }
+        handle_error("Player not found. Please recheck your input.");
+
+        // Names that start with the input, or failing that, names a few typos away from it
+        name_match_t matches[NAME_SEARCH_RESULTS];
+        size_t matched = name_search_prefix(&league, search_name, matches, NAME_SEARCH_RESULTS);
+        if (matched == 0) {
+            matched = name_search_fuzzy(&league, search_name, NAME_SEARCH_EDITS, matches, NAME_SEARCH_RESULTS);
+        }
+        if (matched > 0) {
+            printf("[INFO] Players with a similar name:\n");
+        }
+        for (size_t m = 0; m < matched; m++) {
+            printf("       %s (%s)\n", league_name(&league, matches[m].player), league.clubs[league.club_id[matches[m].player]].name);
+        }
+    } else if (search_option == 2) {
+        int kit_number;
+        printf("> [ACTION] Enter kit number to search: ");
+        if (scanf("%d", &kit_number) != 1) {
+            while (getchar() != '\n'); // Clears the invalid input
+            handle_error("Invalid input for kit number.");
+            return;
+        }
+
+        // The first club (in enrollment order) holding the kit number, then its squad
+        if (validate_kit_number(kit_number) && league.kit_first_club[kit_number] != 0) {
+            const team_t *team = &league.clubs[league.kit_first_club[kit_number] - 1];
+            update_player_position(team_kit_player(&league, team, kit_number));
+            return;
+        }
+        handle_error("Player not found.");
+    }
+}
+
+// --- SHOW AND UPDATE A FOUND PLAYER --- //
+// Name and kit number never change after enrollment, so a position update leaves the indexes valid
+void update_player_position(player_handle_t player) {
+    printf("[INFO] Player found in Club '%s':\n", league.clubs[league.club_id[player]].name);
+    printf("       Name: %s\n", league_name(&league, player));
+    printf("       Kit Number: %d\n", league.kit_number[player]);
+    printf("       Position: %s\n", league.positions[league.position_id[player]]);
+
+    char position[20];
+    printf("> [ACTION] Enter new position for the player: ");
+    scanf(" %19[^\n]", position);
+    if (!league_set_position(&league, player, position)) {
+        handle_error("Out of memory. Position could not be updated.");
+        return;
+    }
+    printf(">> [STATUS UPDATE] Player details updated successfully.\n");
+}
+
+// --- DISPLAY CLUB STATISTICS --- //
+// Figures come from the running aggregates; only the player listing walks the squads
+void display_club_statistics(int list_players) {
+    if (league.club_count == 0) {
+        handle_error("No clubs are available! Please enroll a club first.");
+        return;
+    }
+
+    league_stats_t stats;
+    if (!league_compute_stats(&league, today.year, &stats)) {
+        handle_error("Out of memory. Statistics could not be computed.");
+        return;
+    }
+
+    printf("\n========== LEAGUE STATISTICS ==========\n");
+    for (int i = 0; i < league.club_count; i++) {
+        const team_t *team = &league.clubs[i];
+        printf("\n[TEAM] Club: %s\n", team->name);
+        printf("[INFO] Number of Players: %d\n", team->active_size);
+
+        if (team->active_size == 0) {
+            printf("[ALERT] This team has no players yet.\n");
+            continue;
+        }
+
+        for (player_handle_t h = list_players ? team->first_player : NO_PLAYER; h != NO_PLAYER; h = league.next_in_club[h]) {
+            printf("[PLAYER] Name: %s\n", league_name(&league, h));
+            printf("         Kit Number: %d\n", league.kit_number[h]);
+            printf("         Age: %d\n", league_age(&league, h));
+            printf("         Position: %s\n", league.positions[league.position_id[h]]);
+        }
+
+        float average_age = (float)stats.age_sum[i] / team->active_size;
+        printf("[STATS] Average Player Age: %.2f\n", average_age);
+        printf("[STATS] Age Range: %d - %d\n", stats.min_age[i], stats.max_age[i]);
+        printf("[STATS] Positions:");
+        const int *counts = &stats.position_counts[(size_t)i * stats.position_count];
+        for (int p = 0, listed = 0; p < stats.position_count; p++) {
+            if (counts[p] > 0) {
+                printf("%s %s (%d)", listed++ ? "," : "", league.positions[p], counts[p]);
+            }
+        }
+        printf("\n");
+    }
+
+    if (league.player_count > 0) {
+        printf("\n[STATS] League Age Profile (%zu players, ages %d - %d):\n",
+               league.player_count, stats.min_age_all, stats.max_age_all);
+        for (int b = 0; b < AGE_BINS; b++) {
+            if (stats.age_histogram[b] > 0) {
+                printf("        Age %d: %d\n", AGE_MIN + b, stats.age_histogram[b]);
+            }
+        }
+    }
+    printf("========================================\n");
+    league_stats_free(&stats);
+}
+
+// --- LEAGUE STORAGE --- //
+const char *league_name(const league_t *league, player_handle_t player) {
+    return league->name_pool + league->name_offset[player];
+}
+
+// Age of a stored player today
+int league_age(const league_t *league, player_handle_t player) {
+    age_t dob = {league->birth_day[player], league->birth_month[player], league->birth_year[player]};
+    return age_on(&dob, &today);
+}
+
+int team_has_kit(const team_t *team, int kit_number) {
+    return (int)((team->kit_bits[kit_number >> 6] >> (kit_number & 63)) & 1);
+}
+
+// Holder of a kit number within a squad; squads are small, so a walk beats a per-club table
+player_handle_t team_kit_player(const league_t *league, const team_t *team, int kit_number) {
+    if (!team_has_kit(team, kit_number)) {
+        return NO_PLAYER;
+    }
+    player_handle_t h = atomic_load_explicit(&team->first_player, memory_order_acquire);
+    while (h != NO_PLAYER && league->kit_number[h] != kit_number) {
+        h = atomic_load_explicit(&league->next_in_club[h], memory_order_acquire);
+    }
+    return h;
+}
+
+// --- CONCURRENT ACCESS --- //
+// Enters the league as reader slot `reader`; arrays seen from here on stay allocated until league_read_end
+void league_read_begin(league_t *league, int reader) {
+    atomic_store(&league->readers[reader].epoch, atomic_load(&league->epoch) + 1);
+}
+
+void league_read_end(league_t *league, int reader) {
+    atomic_store_explicit(&league->readers[reader].epoch, 0, memory_order_release);
+}
+
+// Frees every retired array that no reader can still hold
+static void league_reclaim(league_t *league) {
+    unsigned long long oldest = ~0ULL;
+    for (int r = 0; r < READER_SLOTS; r++) {
+        unsigned long long entered = atomic_load(&league->readers[r].epoch);
+        if (entered != 0 && entered - 1 < oldest) {
+            oldest = entered - 1;
+        }
+    }
+    for (retired_t **node = &league->retired; *node != NULL; ) {
+        if ((*node)->epoch < oldest) {
+            retired_t *freed = *node;
+            *node = freed->next;
+            free(freed->memory);
+            free(freed);
+        } else {
+            node = &(*node)->next;
+        }
+    }
+}
+
+// Hands an array that has just been replaced over for freeing; node is preallocated so this cannot fail
+static void league_retire(league_t *league, retired_t *node, void *memory) {
+    if (memory == NULL) {
+        free(node);
+        return;
+    }
+    node->memory = memory;
+    node->epoch = atomic_fetch_add(&league->epoch, 1);
+    node->next = league->retired;
+    league->retired = node;
+    league_reclaim(league);
+}
+
+// Replaces a shared array with a copy of its first `used` entries at `rows` entries, retiring the old
+// one; makes the enclosing function return `failed` if memory runs out
+#define GROW_SHARED(league, array, used, rows, failed) \
+    do { \
+        retired_t *node = malloc(sizeof(retired_t)); \
+        void *grown = malloc((rows) * sizeof(*(array))); \
+        if (node == NULL || grown == NULL) { \
+            free(node); \
+            free(grown); \
+            return failed; \
+        } \
+        void *old = (void *)(array); \
+        if ((used) > 0) { \
+            memcpy(grown, old, (used) * sizeof(*(array))); \
+        } \
+        (array) = grown; \
+        league_retire((league), node, old); \
+    } while (0)
+
+// --- LEAGUE STORAGE --- //
+// Replaces the position tally with one of clubs x positions counts, keeping the enrolled clubs'
+// counts; returns 0 if memory runs out
+static int league_grow_tally(league_t *league, int clubs, int positions) {
+    position_tally_t *old = league->position_tally;
+    positions = (old != NULL && old->positions > positions) ? old->positions : positions;
+    retired_t *node = malloc(sizeof(retired_t));
+    position_tally_t *tally = malloc(sizeof(position_tally_t) + (size_t)clubs * positions * sizeof(atomic_int));
+    if (node == NULL || tally == NULL) {
+        free(node);
+        free(tally);
+        return 0;
+    }
+    tally->positions = positions;
+    memset((void *)tally->counts, 0, (size_t)clubs * positions * sizeof(atomic_int));
+    if (old != NULL) {
+        for (int c = 0; c < league->club_count; c++) {
+            memcpy((void *)&tally->counts[(size_t)c * positions], (void *)&old->counts[(size_t)c * old->positions],
+                   (size_t)old->positions * sizeof(atomic_int));
+        }
+    }
+    league->position_tally = tally;
+    league_retire(league, node, old);
+    return 1;
+}
+
+// Counts a stored player in its club's and the league's running aggregates
+static void league_tally_player(league_t *league, player_handle_t player) {
+    int club = league->club_id[player];
+    int year = birth_cohort(league->birth_year[player], league->birth_month[player], league->birth_day[player]);
+    team_t *team = &league->clubs[club];
+    position_tally_t *tally = league->position_tally;
+    atomic_fetch_add_explicit(&tally->counts[(size_t)club * tally->positions + league->position_id[player]], 1, memory_order_relaxed);
+
+    atomic_fetch_add_explicit(&team->birth_year_sum, year, memory_order_relaxed);
+    if (team->min_birth_year == 0 || year < team->min_birth_year) { // 0 until the first player
+        atomic_store_explicit(&team->min_birth_year, year, memory_order_relaxed);
+    }
+    if (year > team->max_birth_year) {
+        atomic_store_explicit(&team->max_birth_year, year, memory_order_relaxed);
+    }
+
+    atomic_fetch_add_explicit(&league->birth_year_sum, year, memory_order_relaxed);
+    if (league->min_birth_year == 0 || year < league->min_birth_year) {
+        atomic_store_explicit(&league->min_birth_year, year, memory_order_relaxed);
+    }
+    if (year > league->max_birth_year) {
+        atomic_store_explicit(&league->max_birth_year, year, memory_order_relaxed);
+    }
+    int bin = year - BIRTH_YEAR_FIRST;
+    bin = (bin < 0) ? 0 : (bin >= BIRTH_YEARS) ? BIRTH_YEARS - 1 : bin;
+    atomic_fetch_add_explicit(&league->birth_year_counts[bin], 1, memory_order_relaxed);
+}
+
+// Places an id in an id table, which must have a free slot
+static void id_table_place(id_table_t *table, const char *name, int id) {
+    size_t k = name_hash(name) & (table->capacity - 1);
+    while (atomic_load_explicit(&table->slots[k], memory_order_relaxed) != -1) {
+        k = (k + 1) & (table->capacity - 1);
+    }
+    atomic_store_explicit(&table->slots[k], id, memory_order_release);
+}
+
+// An empty id table of the given size; NULL if memory runs out
+static id_table_t *id_table_new(size_t capacity) {
+    id_table_t *table = malloc(sizeof(id_table_t) + capacity * sizeof(atomic_int));
+    if (table != NULL) {
+        table->capacity = capacity;
+        memset((void *)table->slots, 0xFF, capacity * sizeof(atomic_int)); // Every slot -1
+    }
+    return table;
+}
+
+// Rebuilds the position name table at the given size; returns 0 if memory runs out. Only the
+// writer looks positions up by name, so the old table is freed at once.
+static int league_build_position_names(league_t *league, size_t capacity) {
+    id_table_t *table = id_table_new(capacity);
+    if (table == NULL) {
+        return 0;
+    }
+    for (int p = 0; p < league->position_count; p++) {
+        id_table_place(table, league->positions[p], p);
+    }
+    free(league->position_names);
+    league->position_names = table;
+    return 1;
+}
+
+// Id of a position name, adding it on first use; -1 if memory runs out
+int league_intern_position(league_t *league, const char *position) {
+    int count = league->position_count;
+    const id_table_t *names = league->position_names;
+    size_t slots = (names != NULL) ? names->capacity : 0;
+    int id;
+    for (size_t k = name_hash(position) & (slots - 1); slots > 0 && (id = names->slots[k]) != -1; k = (k + 1) & (slots - 1)) {
+        if (strcmp(league->positions[id], position) == 0) {
+            return id;
+        }
+    }
+    if ((size_t)(count + 1) * 2 > slots && !league_build_position_names(league, (slots > 0) ? slots * 2 : 16)) {
+        return -1;
+    }
+    if (count == league->position_capacity) {
+        int capacity = (league->position_capacity > 0) ? league->position_capacity * 2 : 8;
+        if (capacity > 65536) {
+            return -1; // position_id is 16 bits
+        }
+        if (!league_grow_tally(league, league->club_capacity, capacity)) {
+            return -1;
+        }
+        GROW_SHARED(league, league->positions, (size_t)count, (size_t)capacity, -1);
+        league->position_capacity = capacity;
+    }
+    char *name = league->positions[count];
+    strncpy(name, position, sizeof(league->positions[0]) - 1);
+    name[sizeof(league->positions[0]) - 1] = '\0';
+    atomic_store_explicit(&league->position_count, count + 1, memory_order_release);
+    id_table_place(league->position_names, name, count);
+    return count;
+}
+
+// Makes room for one more player in every column; returns 0 if memory runs out
+static int league_reserve_player(league_t *league) {
+    size_t used = league->player_count;
+    if (used < league->player_capacity) {
+        return 1;
+    }
+    size_t rows = (league->player_capacity > 0) ? league->player_capacity * 2 : 64;
+    GROW_SHARED(league, league->birth_year, used, rows, 0);
+    GROW_SHARED(league, league->birth_month, used, rows, 0);
+    GROW_SHARED(league, league->birth_day, used, rows, 0);
+    GROW_SHARED(league, league->kit_number, used, rows, 0);
+    GROW_SHARED(league, league->club_id, used, rows, 0);
+    GROW_SHARED(league, league->position_id, used, rows, 0);
+    GROW_SHARED(league, league->name_offset, used, rows, 0);
+    GROW_SHARED(league, league->next_in_club, used, rows, 0);
+    league->player_capacity = rows;
+    return 1;
+}
+
+// Rebuilds the club name table at the given size, in club id order; returns 0 if memory runs out
+static int league_build_club_names(league_t *league, size_t capacity) {
+    retired_t *node = malloc(sizeof(retired_t));
+    id_table_t *table = id_table_new(capacity);
+    if (node == NULL || table == NULL) {
+        free(node);
+        free(table);
+        return 0;
+    }
+    for (int c = 0; c < league->club_count; c++) {
+        id_table_place(table, league->clubs[c].name, c);
+    }
+    id_table_t *old = league->club_names;
+    league->club_names = table;
+    league_retire(league, node, old);
+    return 1;
+}
+
+// Id of the club with exactly this name, -1 if none. Club names need not be unique; clubs with the
+// same name sit in id order along the probe sequence, so the first enrolled one is found.
+int league_find_club(const league_t *league, const char *name) {
+    const id_table_t *table = atomic_load_explicit(&league->club_names, memory_order_acquire);
+    if (table == NULL) {
+        return -1;
+    }
+    size_t mask = table->capacity - 1;
+    const team_t *clubs = league->clubs;
+    int club;
+    for (size_t k = name_hash(name) & mask; (club = atomic_load_explicit(&table->slots[k], memory_order_acquire)) != -1; k = (k + 1) & mask) {
+        if (strcmp(clubs[club].name, name) == 0) {
+            return club;
+        }
+    }
+    return -1;
+}
+
+// Enrolls a club with an empty squad; returns its id, or -1 if memory runs out
+int league_add_club(league_t *league, const char *name) {
+    int count = league->club_count;
+    const id_table_t *names = league->club_names;
+    size_t slots = (names != NULL) ? names->capacity : 0;
+    if ((size_t)(count + 1) * 2 > slots && !league_build_club_names(league, (slots > 0) ? slots * 2 : 32)) {
+        return -1;
+    }
+    if (count == league->club_capacity) {
+        int capacity = (league->club_capacity > 0) ? league->club_capacity * 2 : 16;
+        if (!league_grow_tally(league, capacity, league->position_capacity)) {
+            return -1;
+        }
+        GROW_SHARED(league, league->clubs, (size_t)count, (size_t)capacity, -1);
+        league->club_capacity = capacity;
+    }
+
+    team_t *clubs = league->clubs;
+    team_t *team = &clubs[count];
+    memset(team, 0, sizeof(*team)); // Padding included, so snapshots are reproducible
+    snprintf(team->name, sizeof(team->name), "%s", name);
+    atomic_init(&team->active_size, 0); // Initializes the player count
+    atomic_init(&team->first_player, NO_PLAYER);
+    atomic_init(&team->last_player, NO_PLAYER);
+    atomic_init(&team->kit_bits[0], 0); // Every kit number free
+    atomic_init(&team->kit_bits[1], 0);
+    atomic_init(&team->birth_year_sum, 0); // Birth year range 0 - 0 until the first player
+    atomic_init(&team->min_birth_year, 0);
+    atomic_init(&team->max_birth_year, 0);
+    position_tally_t *tally = league->position_tally; // A reset league may have counts left in this row
+    memset((void *)&tally->counts[(size_t)count * tally->positions], 0, (size_t)tally->positions * sizeof(atomic_int));
+    atomic_store_explicit(&league->club_count, count + 1, memory_order_release);
+    id_table_place(league->club_names, team->name, count); // Published once the club is
+    return count;
+}
+
+// Stores a player at the end of its club's squad and indexes it by name and kit number. No rules are
+// checked here (see add_player), and the club and position ids must exist. Returns the new handle, or
+// NO_PLAYER if memory runs out.
+// The row is complete before the name index, the squad or the player count can lead a reader to it.
+player_handle_t league_add_player(league_t *league, const player_t *player) {
+    int club = player->club;
+    size_t name_size = strlen(player->name) + 1;
+    if (league->name_pool_used + name_size > league->name_pool_capacity) {
+        size_t capacity = (league->name_pool_capacity > 0) ? league->name_pool_capacity * 2 : 1024;
+        GROW_SHARED(league, league->name_pool, league->name_pool_used, capacity, NO_PLAYER);
+        league->name_pool_capacity = capacity;
+    }
+    if (!league_reserve_player(league)) {
+        return NO_PLAYER;
+    }
+
+    player_handle_t handle = (player_handle_t)league->player_count;
+    memcpy(league->name_pool + league->name_pool_used, player->name, name_size);
+    league->name_offset[handle] = (unsigned int)league->name_pool_used;
+    league->birth_year[handle] = (short)player->dob.year;
+    league->birth_month[handle] = (unsigned char)player->dob.month;
+    league->birth_day[handle] = (unsigned char)player->dob.day;
+    league->kit_number[handle] = (unsigned char)player->kit_number;
+    league->club_id[handle] = club;
+    atomic_store_explicit(&league->position_id[handle], (unsigned short)player->position, memory_order_relaxed);
+    atomic_store_explicit(&league->next_in_club[handle], NO_PLAYER, memory_order_relaxed);
+    if (!name_search_insert(&league->search, league, handle) || !name_index_insert(&league->names, league, handle)) {
+        return NO_PLAYER; // Nothing is counted, so the row and name bytes are simply reused
+    }
+    league->name_pool_used += name_size;
+    atomic_store_explicit(&league->player_count, handle + 1, memory_order_release);
+
+    team_t *team = &league->clubs[club];
+    player_handle_t last = atomic_load_explicit(&team->last_player, memory_order_relaxed);
+    if (last == NO_PLAYER) {
+        atomic_store_explicit(&team->first_player, handle, memory_order_release);
+    } else {
+        atomic_store_explicit(&league->next_in_club[last], handle, memory_order_release);
+    }
+    atomic_store_explicit(&team->last_player, handle, memory_order_release);
+    atomic_fetch_add_explicit(&team->active_size, 1, memory_order_release);
+    league_tally_player(league, handle);
+    atomic_fetch_or_explicit(&team->kit_bits[player->kit_number >> 6], 1ULL << (player->kit_number & 63), memory_order_release);
+    int first = atomic_load_explicit(&league->kit_first_club[player->kit_number], memory_order_relaxed);
+    if (first == 0 || club + 1 < first) {
+        atomic_store_explicit(&league->kit_first_club[player->kit_number], club + 1, memory_order_release);
+    }
+    name_order_merge(&league->search, league);
+    return handle;
+}
+
+// Gives a player another position, moving it between its club's position counts; safe while
+// readers are active
+int league_set_position(league_t *league, player_handle_t player, const char *position) {
+    int position_id = league_intern_position(league, position);
+    if (position_id == -1) {
+        return 0;
+    }
+    position_tally_t *tally = league->position_tally;
+    _Atomic int *row = &tally->counts[(size_t)league->club_id[player] * tally->positions];
+    atomic_fetch_sub_explicit(&row[league->position_id[player]], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&row[position_id], 1, memory_order_relaxed);
+    atomic_store_explicit(&league->position_id[player], (unsigned short)position_id, memory_order_release);
+    return 1;
+}
+
+// Recounts the running aggregates from the columns, for a league whose columns were filled directly;
+// returns 0 if memory runs out
+static int league_rebuild_tallies(league_t *league) {
+    if (!league_grow_tally(league, league->club_capacity, league->position_capacity)) {
+        return 0;
+    }
+    position_tally_t *tally = league->position_tally;
+    memset((void *)tally->counts, 0, (size_t)league->club_capacity * tally->positions * sizeof(atomic_int));
+    for (int c = 0; c < league->club_count; c++) {
+        team_t *team = &league->clubs[c];
+        team->birth_year_sum = 0;
+        team->min_birth_year = team->max_birth_year = 0;
+    }
+    league->birth_year_sum = 0;
+    league->min_birth_year = league->max_birth_year = 0;
+    memset((void *)league->birth_year_counts, 0, sizeof(league->birth_year_counts));
+    for (size_t i = 0; i < league->player_count; i++) {
+        league_tally_player(league, (player_handle_t)i);
+    }
+    return 1;
+}
+
+// Bytes held by the league's storage and indexes
+size_t league_memory(const league_t *league) {
+    size_t row = sizeof(*league->birth_year) + sizeof(*league->birth_month) + sizeof(*league->birth_day) +
+                 sizeof(*league->kit_number) + sizeof(*league->club_id) + sizeof(*league->position_id) +
+                 sizeof(*league->name_offset) + sizeof(*league->next_in_club);
+    const name_table_t *names = league->names.table;
+    const id_table_t *clubs = league->club_names;
+    const id_table_t *positions = league->position_names;
+    return (size_t)league->club_capacity * sizeof(team_t) +
+           league->player_capacity * row +
+           league->name_pool_capacity +
+           (size_t)league->position_capacity * sizeof(league->positions[0]) +
+           ((names != NULL) ? names->capacity * sizeof(name_slot_t) : 0) +
+           ((clubs != NULL) ? clubs->capacity * sizeof(atomic_int) : 0) +
+           ((positions != NULL) ? positions->capacity * sizeof(atomic_int) : 0) +
+           (size_t)league->club_capacity * league->position_capacity * sizeof(atomic_int) +
+           name_search_memory(&league->search);
+}
+
+// Empties the league in O(1): clubs and players are forgotten, their storage is kept for reuse.
+// Like league_free, only for a league no reader is in.
+void league_reset(league_t *league) {
+    league->club_count = 0;
+    league->player_count = 0;
+    league->name_pool_used = 0;
+    league->position_count = 0;
+    name_index_free(&league->names);
+    name_search_reset(&league->search);
+    free(league->club_names);
+    league->club_names = NULL;
+    free(league->position_names);
+    league->position_names = NULL;
+    memset((void *)league->kit_first_club, 0, sizeof(league->kit_first_club));
+    league->birth_year_sum = 0; // Position counts are cleared row by row as clubs are enrolled again
+    league->min_birth_year = league->max_birth_year = 0;
+    memset((void *)league->birth_year_counts, 0, sizeof(league->birth_year_counts));
+}
+
+void league_free(league_t *league) {
+    free(league->clubs);
+    free(league->birth_year);
+    free(league->birth_month);
+    free(league->birth_day);
+    free(league->kit_number);
+    free(league->club_id);
+    free((void *)league->position_id);
+    free(league->name_offset);
+    free((void *)league->next_in_club);
+    free(league->name_pool);
+    free(league->positions);
+    free(league->position_names);
+    free(league->club_names);
+    free(league->position_tally);
+    name_index_free(&league->names);
+    name_search_free(&league->search);
+    while (league->retired != NULL) {
+        retired_t *node = league->retired;
+        league->retired = node->next;
+        free(node->memory);
+        free(node);
+    }
+    memset((void *)league, 0, sizeof(*league));
+}
+
+// --- BULK IMPORT --- //
+// A field of a mapped CSV line, pointing into the file itself
+typedef struct {
+    const char *start;
+    size_t length;
+} csv_field_t;
+
+// Splits a line on commas without copying it; surrounding blanks are trimmed from each field.
+// Returns the number of fields, or max_fields + 1 if the line has more.
+static int csv_split(const char *line, size_t length, csv_field_t *fields, int max_fields) {
+    int count = 0;
+    const char *end = line + length;
+    const char *start = line;
+    while (1) {
+        const char *comma = memchr(start, ',', (size_t)(end - start));
+        const char *stop = (comma != NULL) ? comma : end;
+        if (count == max_fields) {
+            return max_fields + 1;
+        }
+        const char *a = start, *b = stop;
+        while (a < b && (*a == ' ' || *a == '\t')) a++;
+        while (b > a && (b[-1] == ' ' || b[-1] == '\t')) b--;
+        fields[count].start = a;
+        fields[count].length = (size_t)(b - a);
+        count++;
+        if (comma == NULL) {
+            return count;
+        }
+        start = comma + 1;
+    }
+}
+
+// Parses a field holding a small decimal integer; returns 0 if it holds anything else
+static int csv_int(csv_field_t field, int *value) {
+    if (field.length == 0 || field.length > 9) {
+        return 0;
+    }
+    int result = 0;
+    for (size_t i = 0; i < field.length; i++) {
+        if (field.start[i] < '0' || field.start[i] > '9') {
+            return 0;
+        }
+        result = result * 10 + (field.start[i] - '0');
+    }
+    *value = result;
+    return 1;
+}
+
+// Copies a field into a fixed-size string; returns 0 if it is empty or does not fit
+static int csv_text(csv_field_t field, char *out, size_t size) {
+    if (field.length == 0 || field.length >= size) {
+        return 0;
+    }
+    memcpy(out, field.start, field.length);
+    out[field.length] = '\0';
+    return 1;
+}
+
+// Reports one rejected row, the first IMPORT_ERRORS_SHOWN times
+static void import_reject(import_report_t *report, const char *reason) {
+    if (report->rejected++ < IMPORT_ERRORS_SHOWN) {
+        printf("[ERROR] Line %zu: %s\n", report->lines, reason);
+    }
+}
+
+static const char import_out_of_memory[] = "Out of memory."; // Returned by import_player, compared by address
+
+// Checks a player given as the fields club,name,kit_number,position,day,month,year against the rules
+// add_player applies and adds it, enrolling the club on first mention. Returns NULL on success, the
+// rule broken, or import_out_of_memory.
+static const char *import_player(league_t *league, const csv_field_t *fields, player_handle_t *added, int *club_added) {
+    char club_name[21];
+    char position[20];
+    player_t player;
+    *club_added = 0;
+    if (!csv_text(fields[0], club_name, sizeof(club_name))) {
+        return "Club name is empty or exceeds Max Char Limit (20).";
+    }
+    if (!csv_text(fields[1], player.name, sizeof(player.name))) {
+        return "Player name is empty or longer than 24 characters.";
+    }
+    if (!csv_int(fields[2], &player.kit_number) || !validate_kit_number(player.kit_number)) {
+        return KIT_RULE;
+    }
+    if (!csv_text(fields[3], position, sizeof(position))) {
+        return "Position is empty or longer than 19 characters.";
+    }
+    if (!csv_int(fields[4], &player.dob.day) || !csv_int(fields[5], &player.dob.month) ||
+        !csv_int(fields[6], &player.dob.year) || !validate_age(&player.dob)) {
+        return AGE_RULE;
+    }
+
+    int club = league_find_club(league, club_name);
+    if (club == -1) {
+        club = league_add_club(league, club_name);
+        if (club == -1) {
+            return import_out_of_memory;
+        }
+        *club_added = 1;
+    }
+    if (team_has_kit(&league->clubs[club], player.kit_number) ||
+        name_index_find(&league->names, league, player.name, club, 1) != NO_PLAYER) {
+        return "Duplicate entry detected! Player name or kit number must be unique.";
+    }
+    player.club = club;
+    player.position = league_intern_position(league, position);
+    *added = (player.position != -1) ? league_add_player(league, &player) : NO_PLAYER;
+    return (*added == NO_PLAYER) ? import_out_of_memory : NULL;
+}
+
+// Applies one CSV row to the league. "club" alone enrolls a club; "club,name,kit_number,position,
+// day,month,year" adds a player, enrolling the club on first mention. Returns 0 if memory runs out.
+static int import_row(league_t *league, const csv_field_t *fields, int count, import_report_t *report) {
+    if (count == 1) {
+        char club_name[21];
+        if (!csv_text(fields[0], club_name, sizeof(club_name))) {
+            import_reject(report, "Club name is empty or exceeds Max Char Limit (20).");
+        } else if (league_find_club(league, club_name) == -1) {
+            if (league_add_club(league, club_name) == -1) {
+                return 0;
+            }
+            report->clubs_added++;
+        }
+        return 1;
+    }
+    if (count != CSV_FIELDS) {
+        import_reject(report, "Expected 1 or 7 fields: club,name,kit_number,position,day,month,year.");
+        return 1;
+    }
+
+    player_handle_t added;
+    int club_added;
+    const char *error = import_player(league, fields, &added, &club_added);
+    report->clubs_added += (size_t)club_added;
+    if (error == import_out_of_memory) {
+        return 0;
+    } else if (error != NULL) {
+        import_reject(report, error);
+    } else {
+        report->players_added++;
+    }
+    return 1;
+}
+
+// Adds the clubs and players of a CSV file to the league. The file is mapped and tokenized in place;
+// rows that break a rule are reported and skipped. The club and squad limits of the menu are not
+// applied, so imports can build leagues of any size. Returns 0 if the file cannot be read or memory
+// runs out (rows imported until then stay in the league).
+int league_import_csv(league_t *league, const char *path, import_report_t *report) {
+    memset(report, 0, sizeof(*report));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("[ERROR] Cannot open %s: %s\n", path, strerror(errno));
+        return 0;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        printf("[ERROR] Cannot read %s: %s\n", path, strerror(errno));
+        close(fd);
+        return 0;
+    }
+    size_t size = (size_t)st.st_size;
+    if (size == 0) {
+        close(fd);
+        return 1;
+    }
+    const char *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps the file contents reachable
+    if (map == MAP_FAILED) {
+        printf("[ERROR] Cannot map %s: %s\n", path, strerror(errno));
+        return 0;
+    }
+    madvise((void *)map, size, MADV_SEQUENTIAL);
+
+    int ok = 1;
+    const char *end = map + size;
+    for (const char *line = map; line < end && ok; ) {
+        const char *newline = memchr(line, '\n', (size_t)(end - line));
+        const char *stop = (newline != NULL) ? newline : end;
+        size_t length = (size_t)(stop - line);
+        if (length > 0 && line[length - 1] == '\r') {
+            length--;
+        }
+        report->lines++;
+
+        csv_field_t fields[CSV_FIELDS];
+        int count = (length > 0) ? csv_split(line, length, fields, CSV_FIELDS) : 0;
+        int header = report->lines == 1 && count > 0 && fields[0].length == 4 && strncasecmp(fields[0].start, "club", 4) == 0;
+        if (count > 0 && !(count == 1 && fields[0].length == 0) && !header) {
+            ok = import_row(league, fields, count, report);
+        }
+        line = stop + 1;
+    }
+    munmap((void *)map, size);
+
+    if (report->rejected > IMPORT_ERRORS_SHOWN) {
+        printf("[ERROR] %zu more rows rejected.\n", report->rejected - IMPORT_ERRORS_SHOWN);
+    }
+    if (!ok) {
+        printf("[ERROR] Out of memory. Import stopped at line %zu of %s.\n", report->lines, path);
+    }
+    return ok;
+}
+
+// --- LEAGUE SNAPSHOTS --- //
+// Writes one array of a snapshot; returns 0 on a write error
+static int snapshot_write(FILE *file, const void *data, size_t size) {
+    return size == 0 || fwrite(data, 1, size, file) == size;
+}
+
+// Writes the length of every trigram list, then their players back to back
+static int snapshot_write_trigrams(FILE *file, const trigram_list_t *buckets) {
+    for (size_t b = 0; buckets != NULL && b < ((size_t)1 << TRIGRAM_BITS); b++) {
+        uint32_t count = buckets[b].count;
+        if (!snapshot_write(file, &count, sizeof(count))) {
+            return 0;
+        }
+    }
+    for (size_t b = 0; buckets != NULL && b < ((size_t)1 << TRIGRAM_BITS); b++) {
+        if (!snapshot_write(file, buckets[b].players, buckets[b].count * sizeof(player_handle_t))) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Saves the whole league, indexes included, so loading it needs no parsing or rebuilding
+int league_save_snapshot(const league_t *league, const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        printf("[ERROR] Cannot create %s: %s\n", path, strerror(errno));
+        return 0;
+    }
+
+    snapshot_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.team_size = sizeof(team_t);
+    header.kit_min = KIT_MIN;
+    header.kit_max = KIT_MAX;
+    header.age_min = AGE_MIN;
+    header.age_max = AGE_MAX;
+    header.club_count = (uint64_t)league->club_count;
+    header.player_count = league->player_count;
+    header.name_pool_size = league->name_pool_used;
+    header.position_count = (uint64_t)league->position_count;
+    const name_table_t *names = league->names.table;
+    header.name_slots = (names != NULL) ? names->capacity : 0;
+    const name_order_t *order = league->search.order;
+    header.name_order = (order != NULL) ? order->count : 0;
+    const trigram_list_t *buckets = league->search.buckets;
+    header.trigram_buckets = (buckets != NULL) ? (uint64_t)1 << TRIGRAM_BITS : 0;
+    for (size_t b = 0; b < header.trigram_buckets; b++) {
+        header.trigram_postings += buckets[b].count;
+    }
+
+    size_t n = league->player_count;
+    int ok = snapshot_write(file, &header, sizeof(header)) &&
+             snapshot_write(file, (const void *)league->kit_first_club, sizeof(league->kit_first_club)) &&
+             snapshot_write(file, league->clubs, (size_t)league->club_count * sizeof(team_t)) &&
+             snapshot_write(file, league->birth_year, n * sizeof(*league->birth_year)) &&
+             snapshot_write(file, league->birth_month, n * sizeof(*league->birth_month)) &&
+             snapshot_write(file, league->birth_day, n * sizeof(*league->birth_day)) &&
+             snapshot_write(file, league->kit_number, n * sizeof(*league->kit_number)) &&
+             snapshot_write(file, league->club_id, n * sizeof(*league->club_id)) &&
+             snapshot_write(file, (const void *)league->position_id, n * sizeof(*league->position_id)) &&
+             snapshot_write(file, league->name_offset, n * sizeof(*league->name_offset)) &&
+             snapshot_write(file, (const void *)league->next_in_club, n * sizeof(*league->next_in_club)) &&
+             snapshot_write(file, league->name_pool, league->name_pool_used) &&
+             snapshot_write(file, league->positions, (size_t)league->position_count * sizeof(league->positions[0])) &&
+             (names == NULL || snapshot_write(file, (const void *)names->slots, names->capacity * sizeof(name_slot_t))) &&
+             (order == NULL || snapshot_write(file, order->handles, order->count * sizeof(player_handle_t))) &&
+             snapshot_write_trigrams(file, buckets);
+    if (fclose(file) != 0) {
+        ok = 0;
+    }
+    if (!ok) {
+        printf("[ERROR] Cannot write %s: %s\n", path, strerror(errno));
+    }
+    return ok;
+}
+
+// Reads the next bytes of a snapshot; returns 0 on a read error or a short file
+static int snapshot_read(int fd, void *data, size_t size) {
+    for (size_t done = 0; done < size; ) {
+        ssize_t got = read(fd, (char *)data + done, size - done);
+        if (got <= 0) {
+            if (got < 0 && errno == EINTR) {
+                continue;
+            }
+            return 0;
+        }
+        done += (size_t)got;
+    }
+    return 1;
+}
+
+// Reads the next array of a snapshot into a new allocation; NULL on a read error or if memory runs out
+static void *snapshot_take(int fd, size_t size) {
+    void *data = malloc(size > 0 ? size : 1);
+    if (data != NULL && !snapshot_read(fd, data, size)) {
+        free(data);
+        return NULL;
+    }
+    return data;
+}
+
+// Checks every stored index against the counts, so a damaged snapshot cannot point outside the league
+static int snapshot_consistent(const league_t *league) {
+    size_t n = league->player_count;
+    if (league->name_pool_used > 0 && league->name_pool[league->name_pool_used - 1] != '\0') {
+        return 0;
+    }
+    const name_table_t *names = league->names.table;
+    size_t slots = (names != NULL) ? names->capacity : 0;
+    if ((slots & (slots - 1)) != 0) {
+        return 0;
+    }
+    for (int k = 0; k <= KIT_MAX; k++) {
+        if (league->kit_first_club[k] < 0 || league->kit_first_club[k] > league->club_count) {
+            return 0;
+        }
+    }
+    for (int c = 0; c < league->club_count; c++) {
+        const team_t *team = &league->clubs[c];
+        if (memchr(team->name, '\0', sizeof(team->name)) == NULL ||
+            (team->first_player != NO_PLAYER && team->first_player >= n) ||
+            (team->last_player != NO_PLAYER && team->last_player >= n)) {
+            return 0;
+        }
+    }
+    for (int p = 0; p < league->position_count; p++) {
+        if (memchr(league->positions[p], '\0', sizeof(league->positions[p])) == NULL) {
+            return 0;
+        }
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (league->kit_number[i] > KIT_MAX || league->club_id[i] < 0 || league->club_id[i] >= league->club_count ||
+            league->position_id[i] >= league->position_count || league->name_offset[i] >= league->name_pool_used ||
+            (league->next_in_club[i] != NO_PLAYER && league->next_in_club[i] >= n)) {
+            return 0;
+        }
+    }
+    size_t indexed = 0;
+    for (size_t k = 0; k < slots; k++) {
+        if (names->slots[k].player != NO_PLAYER) {
+            if (names->slots[k].player >= n) {
+                return 0;
+            }
+            indexed++;
+        }
+    }
+    // The index must hold every player and keep a free slot, or probes would never end
+    if (indexed != n || (n > 0 && indexed == slots)) {
+        return 0;
+    }
+    // The sorted name order must hold each of the players before its unsorted tail once
+    const name_order_t *order = league->search.order;
+    unsigned char *seen = calloc(order->count / 8 + 1, 1);
+    int valid = seen != NULL;
+    for (size_t i = 0; valid && i < order->count; i++) {
+        player_handle_t player = order->handles[i];
+        valid = player < order->count && !(seen[player / 8] & (1u << (player % 8)));
+        if (valid) {
+            seen[player / 8] |= (unsigned char)(1u << (player % 8));
+        }
+    }
+    free(seen);
+    return valid;
+}
+
+// Checks the stored trigram lists: their lengths add up and each one holds players in handle order
+static int snapshot_trigrams_consistent(const uint32_t *counts, size_t lists, const player_handle_t *postings,
+                                        size_t total, size_t n) {
+    size_t used = 0;
+    for (size_t b = 0; b < lists; b++) {
+        if (counts[b] > total - used) {
+            return 0;
+        }
+        for (size_t i = used; i < used + counts[b]; i++) {
+            if (postings[i] >= n || (i > used && postings[i] <= postings[i - 1])) {
+                return 0;
+            }
+        }
+        used += counts[b];
+    }
+    return used == total;
+}
+
+// Gives every stored trigram list its own allocation, as enrollment would grow it; returns 0 if
+// memory runs out
+static int snapshot_split_trigrams(name_search_t *search, const uint32_t *counts, size_t lists,
+                                   const player_handle_t *postings) {
+    if (lists == 0) {
+        return 1;
+    }
+    search->buckets = calloc(lists, sizeof(trigram_list_t));
+    if (search->buckets == NULL) {
+        return 0;
+    }
+    for (size_t b = 0, used = 0; b < lists; used += counts[b], b++) {
+        trigram_list_t *list = &search->buckets[b];
+        if (counts[b] > 0) {
+            list->players = malloc(counts[b] * sizeof(player_handle_t));
+            if (list->players == NULL) {
+                return 0;
+            }
+            memcpy(list->players, &postings[used], counts[b] * sizeof(player_handle_t));
+            list->count = list->capacity = counts[b];
+        }
+    }
+    return 1;
+}
+
+// Replaces the league with a snapshot. The file is checked before and after it is read in;
+// on any failure the league is left as it was. Arrays are read straight into their final
+// allocations, which is cheaper than mapping the file and copying out of the mapping.
+int league_load_snapshot(league_t *league, const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("[ERROR] Cannot open %s: %s\n", path, strerror(errno));
+        return 0;
+    }
+    struct stat st;
+    snapshot_header_t header;
+    if (fstat(fd, &st) != 0 || read(fd, &header, sizeof(header)) != (ssize_t)sizeof(header)) {
+        printf("[ERROR] %s is not a league snapshot.\n", path);
+        close(fd);
+        return 0;
+    }
+
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 && header.version == SNAPSHOT_VERSION &&
+        (header.kit_min != KIT_MIN || header.kit_max != KIT_MAX || header.age_min != AGE_MIN || header.age_max != AGE_MAX)) {
+        printf("[ERROR] %s was saved under other league rules (kits %d - %d, ages %d - %d).\n", path,
+               header.kit_min, header.kit_max, header.age_min, header.age_max);
+        close(fd);
+        return 0;
+    }
+
+    // Every count is bounded by the file size before the sizes are added up, so they cannot overflow
+    size_t size = (size_t)st.st_size;
+    size_t row = sizeof(short) + 3 * sizeof(unsigned char) + sizeof(int) + sizeof(unsigned short) +
+                 sizeof(unsigned int) + sizeof(player_handle_t);
+    int valid = memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 &&
+                header.version == SNAPSHOT_VERSION && header.team_size == sizeof(team_t) &&
+                header.club_count <= size && header.club_count < (1u << 30) &&
+                header.player_count <= size && header.player_count < NO_PLAYER &&
+                header.name_pool_size <= size && header.name_pool_size <= 0xFFFFFFFFu &&
+                header.position_count <= 65536 && header.name_slots <= size && header.name_order <= header.player_count &&
+                (header.trigram_buckets == ((uint64_t)1 << TRIGRAM_BITS) || (header.trigram_buckets == 0 && header.player_count == 0)) &&
+                header.trigram_postings <= size;
+    if (valid) {
+        size_t expected = sizeof(header) + sizeof(league->kit_first_club) +
+                          header.club_count * sizeof(team_t) + header.player_count * row +
+                          header.name_pool_size + header.position_count * sizeof(league->positions[0]) +
+                          header.name_slots * sizeof(name_slot_t) + header.name_order * sizeof(player_handle_t) +
+                          header.trigram_buckets * sizeof(uint32_t) + header.trigram_postings * sizeof(player_handle_t);
+        valid = expected == size;
+    }
+    if (!valid) {
+        printf("[ERROR] %s is not a league snapshot or is truncated.\n", path);
+        close(fd);
+        return 0;
+    }
+
+    league_t loaded;
+    memset(&loaded, 0, sizeof(loaded));
+    size_t n = header.player_count;
+    int ok = snapshot_read(fd, (void *)loaded.kit_first_club, sizeof(loaded.kit_first_club));
+    loaded.club_count = loaded.club_capacity = (int)header.club_count;
+    loaded.player_count = loaded.player_capacity = n;
+    loaded.name_pool_used = loaded.name_pool_capacity = header.name_pool_size;
+    loaded.position_count = loaded.position_capacity = (int)header.position_count;
+    loaded.names.count = n;
+    loaded.clubs = snapshot_take(fd, header.club_count * sizeof(team_t));
+    loaded.birth_year = snapshot_take(fd, n * sizeof(*loaded.birth_year));
+    loaded.birth_month = snapshot_take(fd, n * sizeof(*loaded.birth_month));
+    loaded.birth_day = snapshot_take(fd, n * sizeof(*loaded.birth_day));
+    loaded.kit_number = snapshot_take(fd, n * sizeof(*loaded.kit_number));
+    loaded.club_id = snapshot_take(fd, n * sizeof(*loaded.club_id));
+    loaded.position_id = snapshot_take(fd, n * sizeof(*loaded.position_id));
+    loaded.name_offset = snapshot_take(fd, n * sizeof(*loaded.name_offset));
+    loaded.next_in_club = snapshot_take(fd, n * sizeof(*loaded.next_in_club));
+    loaded.name_pool = snapshot_take(fd, header.name_pool_size);
+    loaded.positions = snapshot_take(fd, header.position_count * sizeof(loaded.positions[0]));
+    name_table_t *names = (header.name_slots > 0) ? name_table_new(header.name_slots) : NULL;
+    if (names != NULL && !snapshot_read(fd, (void *)names->slots, header.name_slots * sizeof(name_slot_t))) {
+        free(names);
+        names = NULL;
+    }
+    loaded.names.table = names;
+    name_order_t *order = malloc(sizeof(name_order_t) + header.name_order * sizeof(player_handle_t));
+    if (order != NULL) {
+        order->count = header.name_order;
+        if (!snapshot_read(fd, order->handles, header.name_order * sizeof(player_handle_t))) {
+            free(order);
+            order = NULL;
+        }
+    }
+    loaded.search.order = order;
+    uint32_t *trigram_counts = snapshot_take(fd, header.trigram_buckets * sizeof(uint32_t));
+    player_handle_t *postings = snapshot_take(fd, header.trigram_postings * sizeof(player_handle_t));
+    close(fd);
+
+    ok = ok && loaded.clubs != NULL && loaded.birth_year != NULL && loaded.birth_month != NULL &&
+             loaded.birth_day != NULL && loaded.kit_number != NULL && loaded.club_id != NULL &&
+             loaded.position_id != NULL && loaded.name_offset != NULL && loaded.next_in_club != NULL &&
+             loaded.name_pool != NULL && loaded.positions != NULL && (header.name_slots == 0 || names != NULL) &&
+             order != NULL && trigram_counts != NULL && postings != NULL;
+    if (!ok) {
+        printf("[ERROR] Out of memory or read error. %s could not be loaded.\n", path);
+    } else if (!snapshot_consistent(&loaded) ||
+               !snapshot_trigrams_consistent(trigram_counts, header.trigram_buckets, postings, header.trigram_postings, n)) {
+        printf("[ERROR] %s is damaged.\n", path);
+        ok = 0;
+    }
+    // The club and position name tables are not stored; they are rebuilt at the size enrollment would
+    // have grown them to. The running aggregates are recounted rather than trusted.
+    size_t club_slots = 32, position_slots = 16;
+    while ((size_t)(loaded.club_count + 1) * 2 > club_slots) {
+        club_slots *= 2;
+    }
+    while ((size_t)(loaded.position_count + 1) * 2 > position_slots) {
+        position_slots *= 2;
+    }
+    if (ok && (!league_build_club_names(&loaded, club_slots) || !league_build_position_names(&loaded, position_slots) ||
+               !league_rebuild_tallies(&loaded) ||
+               !snapshot_split_trigrams(&loaded.search, trigram_counts, header.trigram_buckets, postings))) {
+        printf("[ERROR] Out of memory. %s could not be loaded.\n", path);
+        ok = 0;
+    }
+    free(trigram_counts);
+    free(postings);
+    if (!ok) {
+        league_free(&loaded);
+        return 0;
+    }
+    league_free(league);
+    *league = loaded;
+    return 1;
+}
+
+// --- LEAGUE STATISTICS --- //
+// League-wide age sum and range over the birth date columns. STATS_LANES independent accumulators
+// per block keep the loop free of cross-iteration dependencies, so it compiles to SIMD min/max/add.
+static void column_age_summary(const short *birth_year, const unsigned char *birth_month, const unsigned char *birth_day,
+                               size_t count, int reference_year, long long *total_age, int *min_age, int *max_age) {
+    int today_key = today.month * 32 + today.day; // See birth_cohort
+    int lane_sum[STATS_LANES] = {0}; // A block of years fits an int; flushed to total_age per block
+    short lane_min[STATS_LANES], lane_max[STATS_LANES];
+    for (int l = 0; l < STATS_LANES; l++) {
+        lane_min[l] = 32767;
+        lane_max[l] = -32768;
+    }
+
+    long long year_sum = 0;
+    size_t i = 0;
+    for (; i + STATS_LANES <= count; i += STATS_LANES) {
+        for (int l = 0; l < STATS_LANES; l++) {
+            short year = (short)(birth_year[i + l] + (birth_month[i + l] * 32 + birth_day[i + l] > today_key));
+            lane_sum[l] += year;
+            lane_min[l] = (year < lane_min[l]) ? year : lane_min[l];
+            lane_max[l] = (year > lane_max[l]) ? year : lane_max[l];
+        }
+        if ((i & 0xFFFF) == 0) { // 4096 blocks at most between flushes, well inside an int
+            for (int l = 0; l < STATS_LANES; l++) {
+                year_sum += lane_sum[l];
+                lane_sum[l] = 0;
+            }
+        }
+    }
+    short min_year = 32767, max_year = -32768;
+    for (int l = 0; l < STATS_LANES; l++) {
+        year_sum += lane_sum[l];
+        min_year = (lane_min[l] < min_year) ? lane_min[l] : min_year;
+        max_year = (lane_max[l] > max_year) ? lane_max[l] : max_year;
+    }
+    for (; i < count; i++) {
+        short year = (short)birth_cohort(birth_year[i], birth_month[i], birth_day[i]);
+        year_sum += year;
+        min_year = (year < min_year) ? year : min_year;
+        max_year = (year > max_year) ? year : max_year;
+    }
+
+    *total_age = (long long)reference_year * (long long)count - year_sum;
+    *min_age = reference_year - max_year;
+    *max_age = reference_year - min_year;
+}
+
+// Every statistic the league reports, read from the running aggregates in O(clubs x positions).
+// While a writer is active the figures may be a few players apart. Returns 0 if memory runs out.
+int league_compute_stats(const league_t *league, int reference_year, league_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    size_t players = atomic_load_explicit(&league->player_count, memory_order_acquire);
+    stats->club_count = atomic_load_explicit(&league->club_count, memory_order_acquire);
+    stats->position_count = atomic_load_explicit(&league->position_count, memory_order_acquire);
+    size_t clubs = (size_t)stats->club_count;
+    size_t positions = (size_t)stats->position_count;
+    stats->age_sum = malloc((clubs + 1) * sizeof(long long));
+    stats->min_age = malloc((clubs + 1) * sizeof(int));
+    stats->max_age = malloc((clubs + 1) * sizeof(int));
+    stats->position_counts = malloc((clubs * positions + 1) * sizeof(int));
+    if (stats->age_sum == NULL || stats->min_age == NULL || stats->max_age == NULL || stats->position_counts == NULL) {
+        league_stats_free(stats);
+        return 0;
+    }
+
+    const team_t *teams = atomic_load_explicit(&league->clubs, memory_order_acquire);
+    const position_tally_t *tally = atomic_load_explicit(&league->position_tally, memory_order_acquire);
+    for (size_t c = 0; c < clubs; c++) {
+        const team_t *team = &teams[c];
+        int size = atomic_load_explicit(&team->active_size, memory_order_relaxed);
+        stats->age_sum[c] = (long long)reference_year * size - atomic_load_explicit(&team->birth_year_sum, memory_order_relaxed);
+        stats->min_age[c] = (size > 0) ? reference_year - atomic_load_explicit(&team->max_birth_year, memory_order_relaxed) : 1 << 30;
+        stats->max_age[c] = (size > 0) ? reference_year - atomic_load_explicit(&team->min_birth_year, memory_order_relaxed) : -(1 << 30);
+        for (size_t p = 0; p < positions; p++) {
+            stats->position_counts[c * positions + p] =
+                atomic_load_explicit(&tally->counts[c * tally->positions + p], memory_order_relaxed);
+        }
+    }
+
+    for (int y = 0; y < BIRTH_YEARS; y++) {
+        int count = atomic_load_explicit(&league->birth_year_counts[y], memory_order_relaxed);
+        int bin = reference_year - (BIRTH_YEAR_FIRST + y) - AGE_MIN;
+        bin = (bin < 0) ? 0 : (bin >= AGE_BINS) ? AGE_BINS - 1 : bin;
+        stats->age_histogram[bin] += count;
+    }
+    stats->total_age = (long long)reference_year * (long long)players - atomic_load_explicit(&league->birth_year_sum, memory_order_relaxed);
+    stats->min_age_all = reference_year - atomic_load_explicit(&league->max_birth_year, memory_order_relaxed);
+    stats->max_age_all = reference_year - atomic_load_explicit(&league->min_birth_year, memory_order_relaxed);
+    return 1;
+}
+
+// The same statistics from one sequential pass over five columns, as a check on the running
+// aggregates. The per-club and histogram updates are scatters; the league-wide sum and range run
+// vectorized on their own. Returns 0 if memory runs out.
+int league_scan_stats(const league_t *league, int reference_year, league_stats_t *stats) {
+    // Players first: every club and position a counted player refers to is then covered by the other counts
+    memset(stats, 0, sizeof(*stats));
+    size_t players = atomic_load_explicit(&league->player_count, memory_order_acquire);
+    stats->club_count = atomic_load_explicit(&league->club_count, memory_order_acquire);
+    stats->position_count = atomic_load_explicit(&league->position_count, memory_order_acquire);
+    size_t clubs = (size_t)stats->club_count;
+    size_t positions = (size_t)stats->position_count;
+    stats->age_sum = calloc(clubs + 1, sizeof(long long));
+    stats->min_age = malloc((clubs + 1) * sizeof(int));
+    stats->max_age = malloc((clubs + 1) * sizeof(int));
+    stats->position_counts = calloc(clubs * positions + 1, sizeof(int));
+    if (stats->age_sum == NULL || stats->min_age == NULL || stats->max_age == NULL || stats->position_counts == NULL) {
+        league_stats_free(stats);
+        return 0;
+    }
+    for (size_t c = 0; c < clubs; c++) {
+        stats->min_age[c] = 1 << 30;
+        stats->max_age[c] = -(1 << 30);
+    }
+
+    // Four sub-histograms, so consecutive players of the same age don't serialize on one counter
+    int histogram[4][AGE_BINS] = {{0}};
+    const short *birth_year = league->birth_year;
+    const unsigned char *birth_month = league->birth_month;
+    const unsigned char *birth_day = league->birth_day;
+    const int *club_id = league->club_id;
+    const _Atomic unsigned short *position_id = league->position_id;
+    for (size_t i = 0; i < players; i++) {
+        int club = club_id[i];
+        int age = reference_year - birth_cohort(birth_year[i], birth_month[i], birth_day[i]);
+        stats->age_sum[club] += age;
+        stats->min_age[club] = (age < stats->min_age[club]) ? age : stats->min_age[club];
+        stats->max_age[club] = (age > stats->max_age[club]) ? age : stats->max_age[club];
+        unsigned int position = atomic_load_explicit(&position_id[i], memory_order_relaxed);
+        if (position < positions) { // A concurrent update may have moved the player to a newer position
+            stats->position_counts[(size_t)club * positions + position]++;
+        }
+
+        int bin = age - AGE_MIN;
+        bin = (bin < 0) ? 0 : (bin >= AGE_BINS) ? AGE_BINS - 1 : bin;
+        histogram[i & 3][bin]++;
+    }
+    for (int b = 0; b < AGE_BINS; b++) {
+        stats->age_histogram[b] = histogram[0][b] + histogram[1][b] + histogram[2][b] + histogram[3][b];
+    }
+
+    column_age_summary(birth_year, birth_month, birth_day, players, reference_year,
+                       &stats->total_age, &stats->min_age_all, &stats->max_age_all);
+    return 1;
+}
+
+void league_stats_free(league_stats_t *stats) {
+    free(stats->age_sum);
+    free(stats->min_age);
+    free(stats->max_age);
+    free(stats->position_counts);
+    memset(stats, 0, sizeof(*stats));
+}
+
+// --- BATCH COMMAND MODE --- //
+static double bench_seconds(struct timespec start, struct timespec end) {
+    return (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+}
+
+typedef enum {
+    BATCH_ENROLL,             // enroll,CLUB
+    BATCH_ADD,                // add,CLUB,NAME,KIT_NUMBER,POSITION,DAY,MONTH,YEAR
+    BATCH_FIND_NAME,          // find-name,NAME
+    BATCH_FIND_KIT,           // find-kit,KIT_NUMBER
+    BATCH_UPDATE_POSITION,    // update-position,NAME,POSITION
+    BATCH_STATS,              // stats[,CLUB]
+    BATCH_FIND_PREFIX,        // find-prefix,PREFIX
+    BATCH_FIND_FUZZY,         // find-fuzzy,NAME
+    BATCH_COMMAND_COUNT
+} batch_command_t;
+
+static const char *batch_command_names[BATCH_COMMAND_COUNT] = {
+    "enroll", "add", "find-name", "find-kit", "update-position", "stats", "find-prefix", "find-fuzzy"
+};
+
+// Latency of every command of one kind, in nanoseconds
+typedef struct {
+    unsigned int *ns;
+    size_t count;
+    size_t capacity;
+} batch_latency_t;
+
+static int batch_latency_record(batch_latency_t *latency, unsigned int ns) {
+    if (latency->count == latency->capacity) {
+        size_t capacity = (latency->capacity > 0) ? latency->capacity * 2 : 1024;
+        unsigned int *grown = realloc(latency->ns, capacity * sizeof(unsigned int));
+        if (grown == NULL) {
+            return 0;
+        }
+        latency->ns = grown;
+        latency->capacity = capacity;
+    }
+    latency->ns[latency->count++] = ns;
+    return 1;
+}
+
+static int compare_uint(const void *a, const void *b) {
+    unsigned int x = *(const unsigned int *)a, y = *(const unsigned int *)b;
+    return (x > y) - (x < y);
+}
+
+// Prints one found player as a result line
+static void batch_player(const char *command, player_handle_t player) {
+    printf("ok\t%s\t%s\t%s\t%d\t%s\t%d\n", command, league.clubs[league.club_id[player]].name,
+           league_name(&league, player), league.kit_number[player],
+           league.positions[league.position_id[player]], league_age(&league, player));
+}
+
+// Runs one command. Results go to stdout as one tab-separated line: "ok", the command and its
+// fields, or "error", the command, the input line number and the reason. Returns 0 if memory runs out.
+static int batch_execute(batch_command_t command, const csv_field_t *fields, int count, size_t line, size_t *errors) {
+    static const int expected_fields[BATCH_COMMAND_COUNT] = {2, 1 + CSV_FIELDS, 2, 2, 3, 1, 2, 2};
+    const char *name = batch_command_names[command];
+    const char *error = NULL;
+    char text[25];
+    player_handle_t found = NO_PLAYER;
+
+    if (count != expected_fields[command] && !(command == BATCH_STATS && count == 2)) {
+        error = "Wrong number of fields.";
+    } else if (command == BATCH_ENROLL) {
+        char club_name[21];
+        if (!csv_text(fields[1], club_name, sizeof(club_name))) {
+            error = "Club name is empty or exceeds Max Char Limit (20).";
+        } else if (league_find_club(&league, club_name) != -1) {
+            error = "Club is already enrolled.";
+        } else {
+            int club = league_add_club(&league, club_name);
+            if (club == -1) {
+                return 0;
+            }
+            printf("ok\t%s\t%d\t%s\n", name, club + 1, club_name);
+        }
+    } else if (command == BATCH_ADD) {
+        int club_added;
+        error = import_player(&league, fields + 1, &found, &club_added);
+        if (error == import_out_of_memory) {
+            return 0;
+        } else if (error == NULL) {
+            printf("ok\t%s\t%s\t%s\t%d\n", name, league.clubs[league.club_id[found]].name,
+                   league_name(&league, found), league.kit_number[found]);
+        }
+    } else if (command == BATCH_FIND_NAME || command == BATCH_UPDATE_POSITION) {
+        if (!csv_text(fields[1], text, sizeof(text)) ||
+            (found = name_index_find(&league.names, &league, text, -1, 0)) == NO_PLAYER) {
+            error = "Player not found.";
+        } else if (command == BATCH_UPDATE_POSITION) {
+            char position[20];
+            if (!csv_text(fields[2], position, sizeof(position))) {
+                error = "Position is empty or longer than 19 characters.";
+            } else if (!league_set_position(&league, found, position)) {
+                return 0;
+            } else {
+                batch_player(name, found);
+            }
+        } else {
+            batch_player(name, found);
+        }
+    } else if (command == BATCH_FIND_KIT) {
+        int kit_number;
+        if (!csv_int(fields[1], &kit_number) || !validate_kit_number(kit_number) || league.kit_first_club[kit_number] == 0) {
+            error = "Player not found.";
+        } else {
+            batch_player(name, team_kit_player(&league, &league.clubs[league.kit_first_club[kit_number] - 1], kit_number));
+        }
+    } else if (command == BATCH_FIND_PREFIX || command == BATCH_FIND_FUZZY) {
+        // One result line per candidate, best first
+        name_match_t matches[NAME_SEARCH_RESULTS];
+        size_t matched = 0;
+        if (csv_text(fields[1], text, sizeof(text))) {
+            matched = (command == BATCH_FIND_PREFIX) ?
+                      name_search_prefix(&league, text, matches, NAME_SEARCH_RESULTS) :
+                      name_search_fuzzy(&league, text, NAME_SEARCH_EDITS, matches, NAME_SEARCH_RESULTS);
+        }
+        for (size_t m = 0; m < matched; m++) {
+            batch_player(name, matches[m].player);
+        }
+        error = (matched == 0) ? "Player not found." : NULL;
+    } else if (count == 1) {
+        // League totals: clubs, players, average, youngest and oldest age today
+        long long total_age = 0;
+        int min_age = 0, max_age = 0;
+        if (league.player_count > 0) {
+            total_age = (long long)today.year * (long long)league.player_count - league.birth_year_sum;
+            min_age = today.year - league.max_birth_year;
+            max_age = today.year - league.min_birth_year;
+        }
+        printf("ok\t%s\t%d\t%zu\t%.2f\t%d\t%d\n", name, league.club_count, league.player_count,
+               league.player_count > 0 ? (double)total_age / league.player_count : 0.0, min_age, max_age);
+    } else {
+        // One club: name, players, average, youngest and oldest age
+        char club_name[21];
+        int club = csv_text(fields[1], club_name, sizeof(club_name)) ? league_find_club(&league, club_name) : -1;
+        if (club == -1) {
+            error = "Club not found.";
+        } else {
+            const team_t *team = &league.clubs[club];
+            long long total_age = 0;
+            int min_age = 0, max_age = 0;
+            if (team->active_size > 0) {
+                total_age = (long long)today.year * team->active_size - team->birth_year_sum;
+                min_age = today.year - team->max_birth_year;
+                max_age = today.year - team->min_birth_year;
+            }
+            printf("ok\t%s\t%s\t%d\t%.2f\t%d\t%d\n", name, team->name, team->active_size,
+                   team->active_size > 0 ? (double)total_age / team->active_size : 0.0, min_age, max_age);
+        }
+    }
+
+    if (error != NULL) {
+        printf("error\t%s\t%zu\t%s\n", name, line, error);
+        (*errors)++;
+    }
+    return 1;
+}
+
+// Runs a command stream from a file, or from standard input for "-", without prompts. Blank lines
+// and lines starting with '#' are skipped. The club and squad limits of the menu are not applied,
+// as in imports. A throughput and per-command latency summary goes to stderr at the end.
+// Returns 0 if the stream cannot be opened or memory runs out.
+int run_batch(const char *path) {
+    FILE *input = (strcmp(path, "-") == 0) ? stdin : fopen(path, "r");
+    if (input == NULL) {
+        printf("[ERROR] Cannot open %s: %s\n", path, strerror(errno));
+        return 0;
+    }
+
+    batch_latency_t latency[BATCH_COMMAND_COUNT];
+    memset(latency, 0, sizeof(latency));
+    char *buffer = NULL;
+    size_t buffer_size = 0, line = 0, commands = 0, errors = 0;
+    ssize_t length;
+    int ok = 1;
+    struct timespec begin, start, end;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+
+    while (ok && (length = getline(&buffer, &buffer_size, input)) != -1) {
+        line++;
+        while (length > 0 && (buffer[length - 1] == '\n' || buffer[length - 1] == '\r')) {
+            length--;
+        }
+        if (length == 0 || buffer[0] == '#') {
+            continue;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        csv_field_t fields[1 + CSV_FIELDS];
+        int count = csv_split(buffer, (size_t)length, fields, 1 + CSV_FIELDS);
+        int command = 0;
+        while (command < BATCH_COMMAND_COUNT &&
+               (strlen(batch_command_names[command]) != fields[0].length ||
+                strncmp(batch_command_names[command], fields[0].start, fields[0].length) != 0)) {
+            command++;
+        }
+        if (command == BATCH_COMMAND_COUNT) {
+            printf("error\t%.*s\t%zu\tUnknown command.\n", (int)fields[0].length, fields[0].start, line);
+            errors++;
+            continue;
+        }
+        ok = batch_execute((batch_command_t)command, fields, count, line, &errors);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double ns = bench_seconds(start, end) * 1e9;
+        ok = ok && batch_latency_record(&latency[command], ns < 4e9 ? (unsigned int)ns : 4000000000u);
+        commands++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    fflush(stdout);
+    free(buffer);
+    if (input != stdin) {
+        fclose(input);
+    }
+    if (!ok) {
+        printf("[ERROR] Out of memory. Batch stopped at line %zu.\n", line);
+        fflush(stdout);
+    }
+
+    double seconds = bench_seconds(begin, end);
+    fprintf(stderr, "[STATS] Batch: %zu commands, %zu errors in %.3f s (%.0f commands/s)\n",
+            commands, errors, seconds, seconds > 0 ? commands / seconds : 0.0);
+    for (int c = 0; c < BATCH_COMMAND_COUNT; c++) {
+        batch_latency_t *l = &latency[c];
+        if (l->count > 0) {
+            qsort(l->ns, l->count, sizeof(unsigned int), compare_uint);
+            fprintf(stderr, "[STATS] %-16s %10zu   p50 %8u ns   p99 %8u ns   max %10u ns\n", batch_command_names[c],
+                    l->count, l->ns[l->count / 2], l->ns[l->count * 99 / 100], l->ns[l->count - 1]);
+        }
+        free(l->ns);
+    }
+    return ok;
+}
+
+// --- PLAYER NAME INDEX --- //
+// FNV-1a over the lower-cased name, so names that differ only in case hash alike
+unsigned int name_hash(const char *name) {
+    unsigned int hash = 2166136261u;
+    for (const unsigned char *c = (const unsigned char *)name; *c != '\0'; c++) {
+        hash ^= (unsigned int)tolower(*c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Allocates an empty table of the given size
+name_table_t *name_table_new(size_t capacity) {
+    name_table_t *table = malloc(sizeof(name_table_t) + capacity * sizeof(name_slot_t));
+    if (table != NULL) {
+        table->capacity = capacity;
+        memset((void *)table->slots, 0xFF, capacity * sizeof(name_slot_t)); // Every slot NO_PLAYER
+    }
+    return table;
+}
+
+// Publishes a player in a slot: the hash first, so a reader that sees the player also sees its hash
+static void name_slot_fill(name_slot_t *slot, unsigned int hash, player_handle_t player) {
+    atomic_store_explicit(&slot->hash, hash, memory_order_relaxed);
+    atomic_store_explicit(&slot->player, player, memory_order_release);
+}
+
+// Replaces the table with one of double the size holding every entry, retiring the old one;
+// returns 0 if memory runs out
+static int name_index_grow(name_index_t *index, league_t *league) {
+    name_table_t *old = index->table;
+    size_t capacity = (old != NULL) ? old->capacity * 2 : NAME_INDEX_MIN_SLOTS;
+    retired_t *node = malloc(sizeof(retired_t));
+    name_table_t *table = name_table_new(capacity);
+    if (node == NULL || table == NULL) {
+        free(node);
+        free(table);
+        return 0;
+    }
+    for (size_t i = 0; old != NULL && i < old->capacity; i++) {
+        player_handle_t player = atomic_load_explicit(&old->slots[i].player, memory_order_relaxed);
+        if (player != NO_PLAYER) {
+            unsigned int hash = atomic_load_explicit(&old->slots[i].hash, memory_order_relaxed);
+            size_t k = hash & (capacity - 1);
+            while (atomic_load_explicit(&table->slots[k].player, memory_order_relaxed) != NO_PLAYER) {
+                k = (k + 1) & (capacity - 1);
+            }
+            name_slot_fill(&table->slots[k], hash, player);
+        }
+    }
+    index->table = table;
+    league_retire(league, node, old);
+    return 1;
+}
+
+// Adds a stored player; returns 0 if memory runs out
+int name_index_insert(name_index_t *index, league_t *league, player_handle_t player) {
+    const name_table_t *current = index->table;
+    if ((current == NULL || (index->count + 1) * 4 > current->capacity * 3) && !name_index_grow(index, league)) {
+        return 0;
+    }
+    name_table_t *table = index->table;
+    unsigned int hash = name_hash(league_name(league, player));
+    size_t k = hash & (table->capacity - 1);
+    while (atomic_load_explicit(&table->slots[k].player, memory_order_relaxed) != NO_PLAYER) {
+        k = (k + 1) & (table->capacity - 1);
+    }
+    name_slot_fill(&table->slots[k], hash, player);
+    index->count++;
+    return 1;
+}
+
+// Finds a player by name, in one club or in any club (club = -1). Several players may share a
+// name, so the earliest one wins: lowest club id, then earliest enrolled, as a scan would.
+player_handle_t name_index_find(const name_index_t *index, const league_t *league, const char *name, int club, int case_sensitive) {
+    const name_table_t *table = atomic_load_explicit(&index->table, memory_order_acquire);
+    if (table == NULL) {
+        return NO_PLAYER;
+    }
+    unsigned int hash = name_hash(name);
+    size_t mask = table->capacity - 1;
+    player_handle_t best = NO_PLAYER, candidate;
+    int best_club = 0;
+    for (size_t k = hash & mask; (candidate = atomic_load_explicit(&table->slots[k].player, memory_order_acquire)) != NO_PLAYER; k = (k + 1) & mask) {
+        if (atomic_load_explicit(&table->slots[k].hash, memory_order_relaxed) != hash) {
+            continue;
+        }
+        int player_club = league->club_id[candidate];
+        if (club >= 0 && player_club != club) {
+            continue;
+        }
+        const char *player_name = league_name(league, candidate);
+        int same = case_sensitive ? strcmp(player_name, name) == 0 : strcasecmp(player_name, name) == 0;
+        if (same && (best == NO_PLAYER || player_club < best_club ||
+                     (player_club == best_club && candidate < best))) {
+            best = candidate;
+            best_club = player_club;
+        }
+    }
+    return best;
+}
+
+void name_index_free(name_index_t *index) {
+    free(index->table);
+    index->table = NULL;
+    index->count = 0;
+}
+
+// --- PLAYER NAME SEARCH --- //
+// Orders two players by case-folded name, then by handle
+static int name_order_compare(const league_t *league, player_handle_t a, player_handle_t b) {
+    int order = strcasecmp(league_name(league, a), league_name(league, b));
+    return (order != 0) ? order : (a > b) - (a < b);
+}
+
+// Sorts players by name (bottom-up merge sort); scratch holds as many handles
+static void name_order_sort(const league_t *league, player_handle_t *handles, player_handle_t *scratch, size_t count) {
+    player_handle_t *from = handles, *to = scratch;
+    for (size_t width = 1; width < count; width *= 2) {
+        for (size_t lo = 0; lo < count; lo += 2 * width) {
+            size_t mid = (lo + width < count) ? lo + width : count;
+            size_t hi = (lo + 2 * width < count) ? lo + 2 * width : count;
+            size_t i = lo, j = mid, k = lo;
+            while (i < mid && j < hi) {
+                to[k++] = (name_order_compare(league, from[i], from[j]) <= 0) ? from[i++] : from[j++];
+            }
+            while (i < mid) {
+                to[k++] = from[i++];
+            }
+            while (j < hi) {
+                to[k++] = from[j++];
+            }
+        }
+        player_handle_t *swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from != handles) {
+        memcpy(handles, from, count * sizeof(player_handle_t));
+    }
+}
+
+// Folds the players added since the last merge into the sorted order, once there are enough of them
+// to slow prefix queries down. Each one is placed by binary search and the runs in between are
+// copied whole. If memory runs out they simply stay in the scanned tail.
+void name_order_merge(name_search_t *search, league_t *league) {
+    name_order_t *old = search->order;
+    size_t sorted = (old != NULL) ? old->count : 0;
+    size_t total = league->player_count;
+    size_t tail = total - sorted;
+    if (tail < NAME_ORDER_MIN_TAIL || tail < sorted / NAME_ORDER_TAIL_SHARE) {
+        return;
+    }
+    retired_t *node = malloc(sizeof(retired_t));
+    name_order_t *order = malloc(sizeof(name_order_t) + total * sizeof(player_handle_t));
+    player_handle_t *added = malloc(2 * tail * sizeof(player_handle_t));
+    if (node == NULL || order == NULL || added == NULL) {
+        free(node);
+        free(order);
+        free(added);
+        return;
+    }
+    for (size_t i = 0; i < tail; i++) {
+        added[i] = (player_handle_t)(sorted + i);
+    }
+    name_order_sort(league, added, added + tail, tail);
+
+    size_t from = 0, to = 0;
+    for (size_t a = 0; a < tail; a++) {
+        size_t lo = from, hi = sorted;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (name_order_compare(league, old->handles[mid], added[a]) < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo > from) {
+            memcpy(&order->handles[to], &old->handles[from], (lo - from) * sizeof(player_handle_t));
+        }
+        to += lo - from;
+        from = lo;
+        order->handles[to++] = added[a];
+    }
+    if (sorted > from) {
+        memcpy(&order->handles[to], &old->handles[from], (sorted - from) * sizeof(player_handle_t));
+    }
+    order->count = total;
+    free(added);
+    atomic_store_explicit(&search->order, order, memory_order_release);
+    league_retire(league, node, old);
+}
+
+// Case-folded trigram at position i of a padded name, spread over the buckets
+static unsigned int trigram_bucket(const unsigned char *padded, size_t i) {
+    unsigned int code = (unsigned int)padded[i] << 16 | (unsigned int)padded[i + 1] << 8 | padded[i + 2];
+    return (code * 2654435761u) >> (32 - TRIGRAM_BITS);
+}
+
+// Distinct trigram buckets of a name, sorted; returns how many. The name is padded with a space at
+// each end, so its first and last letters are in as many trigrams as the others and one edit
+// changes at most three of them.
+static int name_trigrams(const char *name, unsigned int buckets[NAME_SEARCH_MAX]) {
+    unsigned char padded[NAME_SEARCH_MAX + 2];
+    size_t length = 0;
+    padded[length++] = ' ';
+    for (const char *c = name; *c != '\0' && length <= NAME_SEARCH_MAX; c++) {
+        padded[length++] = (unsigned char)tolower((unsigned char)*c);
+    }
+    padded[length++] = ' ';
+
+    int count = 0;
+    for (size_t i = 0; i + 2 < length; i++) {
+        unsigned int bucket = trigram_bucket(padded, i);
+        int k = 0;
+        while (k < count && buckets[k] < bucket) {
+            k++;
+        }
+        if (k < count && buckets[k] == bucket) {
+            continue;
+        }
+        memmove(&buckets[k + 1], &buckets[k], (size_t)(count - k) * sizeof(unsigned int));
+        buckets[k] = bucket;
+        count++;
+    }
+    return count;
+}
+
+// Adds a stored player to the trigram lists of its name; returns 0 if memory runs out, in which
+// case no list has gained it. A handle left at the end of a list by an enrollment that failed
+// later on is not repeated when the handle is reused.
+int name_search_insert(name_search_t *search, league_t *league, player_handle_t player) {
+    if (search->buckets == NULL) {
+        trigram_list_t *buckets = calloc((size_t)1 << TRIGRAM_BITS, sizeof(trigram_list_t));
+        if (buckets == NULL) {
+            return 0;
+        }
+        atomic_store_explicit(&search->buckets, buckets, memory_order_release);
+    }
+    unsigned int trigrams[NAME_SEARCH_MAX];
+    int count = name_trigrams(league_name(league, player), trigrams);
+    for (int t = 0; t < count; t++) {
+        trigram_list_t *list = &search->buckets[trigrams[t]];
+        if (list->count == list->capacity) {
+            unsigned int capacity = (list->capacity > 0) ? list->capacity * 2 : 8;
+            GROW_SHARED(league, list->players, (size_t)list->count, (size_t)capacity, 0);
+            list->capacity = capacity;
+        }
+    }
+    for (int t = 0; t < count; t++) {
+        trigram_list_t *list = &search->buckets[trigrams[t]];
+        unsigned int used = list->count;
+        if (used == 0 || list->players[used - 1] != player) {
+            list->players[used] = player;
+            atomic_store_explicit(&list->count, used + 1, memory_order_release);
+        }
+    }
+    return 1;
+}
+
+// Keeps matches ranked and at most limit long: by distance first when asked, then by name
+static void name_match_insert(const league_t *league, name_match_t *matches, size_t *found, size_t limit,
+                              name_match_t match, int by_distance) {
+    size_t k = *found;
+    while (k > 0 && ((by_distance && match.distance != matches[k - 1].distance) ?
+                     match.distance < matches[k - 1].distance :
+                     name_order_compare(league, match.player, matches[k - 1].player) < 0)) {
+        k--;
+    }
+    if (k >= limit) {
+        return;
+    }
+    size_t kept = (*found < limit) ? *found : limit - 1;
+    memmove(&matches[k + 1], &matches[k], (kept - k) * sizeof(name_match_t));
+    matches[k] = match;
+    *found = kept + 1;
+}
+
+// Up to limit players whose name starts with prefix (any case), in case-folded alphabetical order,
+// so an exact match comes first; returns how many were written
+size_t name_search_prefix(const league_t *league, const char *prefix, name_match_t *matches, size_t limit) {
+    const name_order_t *order = atomic_load_explicit(&league->search.order, memory_order_acquire);
+    size_t players = atomic_load_explicit(&league->player_count, memory_order_acquire);
+    size_t sorted = (order != NULL) ? order->count : 0;
+    size_t length = strlen(prefix);
+    size_t found = 0;
+
+    // The sorted players with the prefix form one run, already in rank order
+    size_t lo = 0, hi = sorted;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (strcasecmp(league_name(league, order->handles[mid]), prefix) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    for (size_t i = lo; i < sorted && found < limit; i++) {
+        const char *name = league_name(league, order->handles[i]);
+        if (strncasecmp(name, prefix, length) != 0) {
+            break;
+        }
+        matches[found++] = (name_match_t){order->handles[i], (int)(strlen(name) - length)};
+    }
+
+    // The unsorted tail; its names lie back to back in the name pool
+    int first = tolower((unsigned char)prefix[0]);
+    for (size_t h = sorted; h < players; h++) {
+        const char *name = league_name(league, (player_handle_t)h);
+        if ((length == 0 || tolower((unsigned char)name[0]) == first) && strncasecmp(name, prefix, length) == 0) {
+            name_match_t match = {(player_handle_t)h, (int)(strlen(name) - length)};
+            name_match_insert(league, matches, &found, limit, match, 0);
+        }
+    }
+    return found;
+}
+
+// Edits between two names ignoring case, or limit + 1 as soon as there must be more than limit.
+// Only cells within limit of the diagonal can stay within limit, so only that band is computed;
+// the cells outside it count as limit + 1.
+static int name_distance(const char *query, const char *name, int limit) {
+    int query_length = (int)strlen(query), name_length = (int)strlen(name);
+    if (name_length > NAME_SEARCH_MAX || abs(query_length - name_length) > limit) {
+        return limit + 1;
+    }
+    int row[NAME_SEARCH_MAX + 1];
+    for (int j = 0; j <= name_length; j++) {
+        row[j] = (j <= limit) ? j : limit + 1;
+    }
+    for (int i = 1; i <= query_length; i++) {
+        int lo = (i - limit > 1) ? i - limit : 1;
+        int hi = (i + limit < name_length) ? i + limit : name_length;
+        int diagonal = row[lo - 1];
+        row[lo - 1] = (lo == 1 && i <= limit) ? i : limit + 1;
+        int best = row[lo - 1];
+        int q = tolower((unsigned char)query[i - 1]);
+        for (int j = lo; j <= hi; j++) {
+            int cost = diagonal + (q != tolower((unsigned char)name[j - 1]));
+            cost = (row[j] + 1 < cost) ? row[j] + 1 : cost;
+            cost = (row[j - 1] + 1 < cost) ? row[j - 1] + 1 : cost;
+            cost = (cost < limit + 1) ? cost : limit + 1;
+            diagonal = row[j];
+            row[j] = cost;
+            best = (cost < best) ? cost : best;
+        }
+        if (best > limit) {
+            return limit + 1;
+        }
+    }
+    return (row[name_length] <= limit) ? row[name_length] : limit + 1;
+}
+
+// First position from `from` on whose handle is not below target, galloping then bisecting
+static unsigned int trigram_list_seek(const player_handle_t *players, unsigned int length, unsigned int from,
+                                      player_handle_t target) {
+    unsigned int lo = from, hi = from, step = 1;
+    while (hi < length && players[hi] < target) {
+        lo = hi + 1;
+        hi += step;
+        step *= 2;
+    }
+    hi = (hi < length) ? hi : length;
+    while (lo < hi) {
+        unsigned int mid = lo + (hi - lo) / 2;
+        if (players[mid] < target) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Up to limit players within max_edits edits of name (any case), closest first, then by name;
+// returns how many were written. An edit changes at most three trigrams, so a match lacks at most
+// 3 x edits of the query's and must be in one of its 3 x edits + 1 rarest lists: candidates come
+// from merging those, and are looked up in the longer lists until they miss too many. Only the
+// survivors are compared in full. Short queries tolerate fewer edits, as they have few trigrams.
+size_t name_search_fuzzy(const league_t *league, const char *name, int max_edits, name_match_t *matches, size_t limit) {
+    const trigram_list_t *buckets = atomic_load_explicit(&league->search.buckets, memory_order_acquire);
+    unsigned int trigrams[NAME_SEARCH_MAX];
+    int count = name_trigrams(name, trigrams);
+    if (buckets == NULL || count == 0 || limit == 0) {
+        return 0;
+    }
+    int edits = (int)strlen(name) / FUZZY_LETTERS_PER_EDIT;
+    edits = (edits < (count - 1) / 3) ? edits : (count - 1) / 3;
+    edits = (edits < max_edits) ? edits : max_edits;
+    int misses_allowed = 3 * edits;
+    int rare = misses_allowed + 1;
+
+    // The lists, shortest first
+    const player_handle_t *players[NAME_SEARCH_MAX];
+    unsigned int length[NAME_SEARCH_MAX], next[NAME_SEARCH_MAX];
+    for (int t = 0; t < count; t++) {
+        const trigram_list_t *list = &buckets[trigrams[t]];
+        unsigned int size = atomic_load_explicit(&list->count, memory_order_acquire);
+        const player_handle_t *held = atomic_load_explicit(&list->players, memory_order_acquire);
+        int k = t;
+        for (; k > 0 && length[k - 1] > size; k--) {
+            length[k] = length[k - 1];
+            players[k] = players[k - 1];
+        }
+        length[k] = size;
+        players[k] = held;
+    }
+    memset(next, 0, sizeof(next));
+
+    // Merge the rare lists by handle; each is sorted and holds a player at most once
+    size_t found = 0;
+    while (1) {
+        player_handle_t candidate = NO_PLAYER;
+        for (int l = 0; l < rare; l++) {
+            if (next[l] < length[l] && players[l][next[l]] < candidate) {
+                candidate = players[l][next[l]];
+            }
+        }
+        if (candidate == NO_PLAYER) {
+            break;
+        }
+        int misses = rare;
+        for (int l = 0; l < rare; l++) {
+            if (next[l] < length[l] && players[l][next[l]] == candidate) {
+                misses--;
+                next[l]++;
+            }
+        }
+        for (int l = rare; l < count && misses <= misses_allowed; l++) {
+            next[l] = trigram_list_seek(players[l], length[l], next[l], candidate);
+            misses += next[l] == length[l] || players[l][next[l]] != candidate;
+        }
+        if (misses <= misses_allowed) {
+            int distance = name_distance(name, league_name(league, candidate), edits);
+            if (distance <= edits) {
+                name_match_insert(league, matches, &found, limit, (name_match_t){candidate, distance}, 1);
+            }
+        }
+    }
+    return found;
+}
+
+// Bytes held by the sorted order and the trigram lists
+size_t name_search_memory(const name_search_t *search) {
+    size_t bytes = (search->order != NULL) ? sizeof(name_order_t) + search->order->count * sizeof(player_handle_t) : 0;
+    for (size_t b = 0; search->buckets != NULL && b < ((size_t)1 << TRIGRAM_BITS); b++) {
+        bytes += sizeof(trigram_list_t) + search->buckets[b].capacity * sizeof(player_handle_t);
+    }
+    return bytes;
+}
+
+// Forgets every player, keeping the trigram lists' storage (no reader may be in the league)
+void name_search_reset(name_search_t *search) {
+    free(search->order);
+    search->order = NULL;
+    for (size_t b = 0; search->buckets != NULL && b < ((size_t)1 << TRIGRAM_BITS); b++) {
+        search->buckets[b].count = 0;
+    }
+}
+
+void name_search_free(name_search_t *search) {
+    for (size_t b = 0; search->buckets != NULL && b < ((size_t)1 << TRIGRAM_BITS); b++) {
+        free(search->buckets[b].players);
+    }
+    free(search->buckets);
+    free(search->order);
+    search->buckets = NULL;
+    search->order = NULL;
+}
+
+// --- PLAYER INDEX BENCHMARK --- //
+static unsigned int bench_rand(unsigned int *state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+// Fills a synthetic player of a club: name unique by serial, kit number unique within a squad of
+// SQUAD_SIZE, valid age today. The position is interned in league unless that is NULL (the id is then
+// -1). Returns the position name, or NULL if memory runs out.
+static const char *bench_player(league_t *league, player_t *player, int club, int serial, int squad_slot, unsigned int *rng) {
+    static const char *first_names[] = {"Ali", "Omar", "Yusuf", "Karim", "Sami", "Tariq", "Hadi", "Rami"};
+    static const char *last_names[] = {"Haddad", "Nasser", "Saleh", "Khalil", "Mansour", "Aziz", "Farah", "Jaber"};
+    static const char *positions[] = {"Goalkeeper", "Defender", "Midfielder", "Forward"};
+    unsigned int r = bench_rand(rng);
+    int kits = KIT_NUMBERS / SQUAD_SIZE; // Kit numbers per squad slot
+    snprintf(player->name, sizeof(player->name), "%s %s %d", first_names[r % 8], last_names[(r >> 3) % 8], serial);
+    player->kit_number = KIT_MIN + squad_slot * kits + (int)((r >> 6) % (unsigned int)kits);
+    player->club = club;
+    player->dob.day = 1 + (int)((r >> 9) % 28);
+    player->dob.month = 1 + (int)((r >> 14) % 12);
+    int age = AGE_MIN + (int)((r >> 18) % (AGE_MAX - AGE_MIN + 1));
+    int birthday_ahead = player->dob.month > today.month || (player->dob.month == today.month && player->dob.day > today.day);
+    player->dob.year = today.year - age - birthday_ahead;
+    const char *position = positions[(r >> 24) % 4];
+    player->position = (league != NULL) ? league_intern_position(league, position) : -1;
+    return (league == NULL || player->position != -1) ? position : NULL;
+}
+
+// Builds a league of player_count synthetic players in full squads; returns 0 if memory runs out
+static int bench_fill_league(league_t *bench, int player_count, unsigned int *rng) {
+    for (int i = 0; i < player_count; i++) {
+        player_t player;
+        if ((i % SQUAD_SIZE == 0 && league_add_club(bench, "Bench FC") == -1) ||
+            bench_player(bench, &player, bench->club_count - 1, i, i % SQUAD_SIZE, rng) == NULL ||
+            league_add_player(bench, &player) == NO_PLAYER) {
+            handle_error("Out of memory. Benchmark aborted.");
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Indexed lookups against the linear scans they replace, over BENCH_PLAYERS synthetic players in full squads
+void benchmark_player_index() {
+    int player_count = BENCH_PLAYERS;
+    int club_count = (player_count + SQUAD_SIZE - 1) / SQUAD_SIZE;
+    league_t bench = {0};
+    unsigned int rng = 2024;
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (!bench_fill_league(&bench, player_count, &rng)) {
+        league_free(&bench);
+        return;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("\n========== PLAYER INDEX BENCHMARK ==========\n");
+    printf("[INFO] %d players in %d clubs\n", player_count, club_count);
+    printf("[STATS] League build         : %.1f ms (storage and indexes)\n", bench_seconds(start, end) * 1e3);
+
+    // Name queries use upper-cased names, so every hit goes through the case-insensitive path
+    enum { INDEX_QUERIES = 200000, SCAN_QUERIES = 20 };
+    char (*queries)[25] = malloc(INDEX_QUERIES * sizeof(*queries));
+    if (queries == NULL) {
+        handle_error("Out of memory. Benchmark aborted.");
+        league_free(&bench);
+        return;
+    }
+    for (int q = 0; q < INDEX_QUERIES; q++) {
+        const char *name = league_name(&bench, bench_rand(&rng) % (unsigned int)player_count);
+        for (int c = 0; c < 25; c++) {
+            queries[q][c] = (char)toupper((unsigned char)name[c]);
+            if (name[c] == '\0') {
+                break;
+            }
+        }
+    }
+
+    long long found = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int q = 0; q < INDEX_QUERIES; q++) {
+        found += name_index_find(&bench.names, &bench, queries[q], -1, 0) != NO_PLAYER;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("[STATS] Name lookup (index)  : %.1f ns/query (%lld of %d found)\n",
+           bench_seconds(start, end) * 1e9 / INDEX_QUERIES, found, INDEX_QUERIES);
+
+    found = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int q = 0; q < SCAN_QUERIES; q++) {
+        for (int i = 0; i < player_count; i++) {
+            if (strcasecmp(league_name(&bench, (player_handle_t)i), queries[q]) == 0) {
+                found++;
+                break;
+            }
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("[STATS] Name lookup (scan)   : %.1f ns/query (%lld of %d found)\n",
+           bench_seconds(start, end) * 1e9 / SCAN_QUERIES, found, SCAN_QUERIES);
+
+    // League-wide kit search: first club holding the number, then its squad
+    long long checksum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int q = 0; q < INDEX_QUERIES; q++) {
+        int kit = KIT_MIN + q % KIT_MAX;
+        if (bench.kit_first_club[kit] != 0) {
+            checksum += team_kit_player(&bench, &bench.clubs[bench.kit_first_club[kit] - 1], kit);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("[STATS] Kit lookup (index)   : %.1f ns/query (checksum %lld)\n",
+           bench_seconds(start, end) * 1e9 / INDEX_QUERIES, checksum);
+
+    checksum = 0;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int q = 0; q < SCAN_QUERIES * 100; q++) {
+        int kit = KIT_MIN + q % KIT_MAX;
+        for (int i = 0; i < player_count; i++) {
+            if (bench.kit_number[i] == kit) {
+                checksum += i;
+                break;
+            }
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("[STATS] Kit lookup (scan)    : %.1f ns/query (checksum %lld)\n",
+           bench_seconds(start, end) * 1e9 / (SCAN_QUERIES * 100), checksum);
+
+    // Prefix queries drop the last two letters of a name; fuzzy queries change two of its letters
+    enum { SEARCH_QUERIES = 20000 };
+    unsigned int *latency = malloc(SEARCH_QUERIES * sizeof(unsigned int));
+    if (latency == NULL) {
+        handle_error("Out of memory. Benchmark aborted.");
+        free(queries);
+        league_free(&bench);
+        return;
+    }
+    long long results = 0;
+    for (int q = 0; q < SEARCH_QUERIES; q++) {
+        char prefix[25];
+        snprintf(prefix, sizeof(prefix), "%s", queries[q]);
+        prefix[strlen(prefix) - 2] = '\0';
+        name_match_t matches[NAME_SEARCH_RESULTS];
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        results += (long long)name_search_prefix(&bench, prefix, matches, NAME_SEARCH_RESULTS);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        latency[q] = (unsigned int)(bench_seconds(start, end) * 1e9);
+    }
+    qsort(latency, SEARCH_QUERIES, sizeof(unsigned int), compare_uint);
+    printf("[STATS] Prefix search        : p50 %.1f us, p99 %.1f us, max %.1f us (%.1f results each)\n",
+           latency[SEARCH_QUERIES / 2] / 1e3, latency[SEARCH_QUERIES * 99 / 100] / 1e3,
+           latency[SEARCH_QUERIES - 1] / 1e3, (double)results / SEARCH_QUERIES);
+
+    found = 0;
+    for (int q = 0; q < SEARCH_QUERIES; q++) {
+        char typo[25];
+        snprintf(typo, sizeof(typo), "%s", queries[q]);
+        size_t length = strlen(typo);
+        typo[bench_rand(&rng) % length] = 'x';
+        typo[bench_rand(&rng) % length] = 'q';
+        name_match_t matches[NAME_SEARCH_RESULTS];
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        size_t matched = name_search_fuzzy(&bench, typo, NAME_SEARCH_EDITS, matches, NAME_SEARCH_RESULTS);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        latency[q] = (unsigned int)(bench_seconds(start, end) * 1e9);
+        for (size_t m = 0; m < matched; m++) {
+            if (strcasecmp(league_name(&bench, matches[m].player), queries[q]) == 0) {
+                found++;
+                break;
+            }
+        }
+    }
+    qsort(latency, SEARCH_QUERIES, sizeof(unsigned int), compare_uint);
+    printf("[STATS] Fuzzy search         : p50 %.1f us, p99 %.1f us, max %.1f us (%lld of %d found with %d typos)\n",
+           latency[SEARCH_QUERIES / 2] / 1e3, latency[SEARCH_QUERIES * 99 / 100] / 1e3,
+           latency[SEARCH_QUERIES - 1] / 1e3, found, SEARCH_QUERIES, NAME_SEARCH_EDITS);
+    printf("[STATS] Search index memory  : %.1f MB\n", name_search_memory(&bench.search) / 1048576.0);
+    printf("============================================\n");
+
+    free(latency);
+    free(queries);
+    league_free(&bench);
+}
+
+// --- LEAGUE STORAGE BENCHMARK --- //
+// BENCH_CLUBS clubs with squads of 1..SQUAD_SIZE players: insert rate, footprint, reset and refill
+void benchmark_league_storage() {
+    league_t bench = {0};
+    long long players = 0;
+    printf("\n========== LEAGUE STORAGE BENCHMARK ==========\n");
+
+    for (int pass = 0; pass < 2; pass++) {
+        unsigned int rng = 2024; // Same league both passes; the second one reuses the storage
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        players = 0;
+        for (int c = 0; c < BENCH_CLUBS; c++) {
+            int club = league_add_club(&bench, "Bench FC");
+            int squad = 1 + (int)(bench_rand(&rng) % SQUAD_SIZE);
+            for (int s = 0; s < squad && club != -1; s++) {
+                player_t player;
+                if (bench_player(&bench, &player, club, (int)players, s, &rng) == NULL ||
+                    league_add_player(&bench, &player) == NO_PLAYER) {
+                    club = -1;
+                }
+                players++;
+            }
+            if (club == -1) {
+                handle_error("Out of memory. Benchmark aborted.");
+                league_free(&bench);
+                return;
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double seconds = bench_seconds(start, end);
+        printf("[STATS] %s: %d clubs, %lld players in %.1f ms (%.2f M players/s)\n",
+               pass == 0 ? "Fresh build " : "After reset ", BENCH_CLUBS, players, seconds * 1e3, players / seconds / 1e6);
+
+        if (pass == 0) {
+            size_t fixed = (size_t)BENCH_CLUBS * SQUAD_SIZE * sizeof(player_t);
+            printf("[STATS] Memory footprint    : %.1f MB (%.1f bytes/player, indexes included)\n",
+                   league_memory(&bench) / 1048576.0, (double)league_memory(&bench) / (double)players);
+            printf("[STATS] Fixed squads would  : %.1f MB for player slots alone\n", fixed / 1048576.0);
+
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            league_reset(&bench);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            printf("[STATS] Bulk reset          : %.3f ms (%zu player rows kept)\n",
+                   bench_seconds(start, end) * 1e3, bench.player_capacity);
+        }
+    }
+    printf("==============================================\n");
+    league_free(&bench);
+}
+
+// --- PLAYER COLUMNS BENCHMARK --- //
+// The fixed squads of whole player_t records that the league used to keep
+typedef struct {
+    char name[20];
+    player_t players[SQUAD_SIZE];
+    int active_size;
+} bench_team_t;
+
+// league_compute_stats over the row layout: same results, but each player drags in its whole record
+static void bench_row_stats(const bench_team_t *teams, int club_count, int reference_year, league_stats_t *stats) {
+    int positions = stats->position_count;
+    for (int c = 0; c < club_count; c++) {
+        stats->age_sum[c] = 0;
+        stats->min_age[c] = 1 << 30;
+        stats->max_age[c] = -(1 << 30);
+    }
+    memset(stats->position_counts, 0, (size_t)club_count * positions * sizeof(int));
+    memset(stats->age_histogram, 0, sizeof(stats->age_histogram));
+    stats->total_age = 0;
+    stats->min_age_all = 1 << 30;
+    stats->max_age_all = -(1 << 30);
+
+    for (int c = 0; c < club_count; c++) {
+        for (int i = 0; i < teams[c].active_size; i++) {
+            const player_t *player = &teams[c].players[i];
+            int age = reference_year - birth_cohort(player->dob.year, player->dob.month, player->dob.day);
+            stats->age_sum[c] += age;
+            stats->min_age[c] = (age < stats->min_age[c]) ? age : stats->min_age[c];
+            stats->max_age[c] = (age > stats->max_age[c]) ? age : stats->max_age[c];
+            stats->position_counts[(size_t)c * positions + player->position]++;
+            int bin = age - AGE_MIN;
+            bin = (bin < 0) ? 0 : (bin >= AGE_BINS) ? AGE_BINS - 1 : bin;
+            stats->age_histogram[bin]++;
+            stats->total_age += age;
+            stats->min_age_all = (age < stats->min_age_all) ? age : stats->min_age_all;
+            stats->max_age_all = (age > stats->max_age_all) ? age : stats->max_age_all;
+        }
+    }
+}
+
+// Whether two sets of statistics over the same clubs and positions agree
+static int bench_stats_equal(const league_stats_t *a, const league_stats_t *b) {
+    size_t clubs = (size_t)a->club_count;
+    return a->club_count == b->club_count && a->position_count == b->position_count &&
+           a->total_age == b->total_age && a->min_age_all == b->min_age_all && a->max_age_all == b->max_age_all &&
+           memcmp(a->age_histogram, b->age_histogram, sizeof(a->age_histogram)) == 0 &&
+           memcmp(a->age_sum, b->age_sum, clubs * sizeof(long long)) == 0 &&
+           memcmp(a->min_age, b->min_age, clubs * sizeof(int)) == 0 &&
+           memcmp(a->max_age, b->max_age, clubs * sizeof(int)) == 0 &&
+           memcmp(a->position_counts, b->position_counts, clubs * a->position_count * sizeof(int)) == 0;
+}
+
+// Row layout against column layout for the league statistics and the average-age pass alone,
+// over BENCH_PLAYERS synthetic players. Best of five runs each.
+void benchmark_player_columns() {
+    int player_count = BENCH_PLAYERS;
+    int club_count = (player_count + SQUAD_SIZE - 1) / SQUAD_SIZE;
+    league_t bench = {0};
+    unsigned int rng = 2024;
+    if (!bench_fill_league(&bench, player_count, &rng)) {
+        league_free(&bench);
+        return;
+    }
+
+    // The same players in the row layout, rebuilt from the same generator
+    bench_team_t *teams = calloc((size_t)club_count, sizeof(bench_team_t));
+    league_stats_t row_stats, column_stats;
+    if (teams == NULL || !league_compute_stats(&bench, today.year, &row_stats)) {
+        handle_error("Out of memory. Benchmark aborted.");
+        free(teams);
+        league_free(&bench);
+        return;
+    }
+    rng = 2024;
+    for (int i = 0; i < player_count; i++) {
+        bench_team_t *team = &teams[i / SQUAD_SIZE];
+        bench_player(&bench, &team->players[team->active_size++], i / SQUAD_SIZE, i, i % SQUAD_SIZE, &rng);
+    }
+
+    double row_best = 1e9, column_best = 1e9, running_best = 1e9, row_avg_best = 1e9, column_avg_best = 1e9;
+    league_stats_t running_stats = {0};
+    long long row_check = 0, column_check = 0;
+    struct timespec start, end;
+    for (int run = 0; run < 5; run++) {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        bench_row_stats(teams, club_count, today.year, &row_stats);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        row_best = (bench_seconds(start, end) < row_best) ? bench_seconds(start, end) : row_best;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        league_scan_stats(&bench, today.year, &column_stats);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        column_best = (bench_seconds(start, end) < column_best) ? bench_seconds(start, end) : column_best;
+        if (run < 4) {
+            league_stats_free(&column_stats);
+        }
+
+        league_stats_free(&running_stats);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        league_compute_stats(&bench, today.year, &running_stats);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        running_best = (bench_seconds(start, end) < running_best) ? bench_seconds(start, end) : running_best;
+
+        // What the old statistics screen computed: the league's age sum
+        long long sum = 0;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (int c = 0; c < club_count; c++) {
+            for (int i = 0; i < teams[c].active_size; i++) {
+                const age_t *dob = &teams[c].players[i].dob;
+                sum += today.year - birth_cohort(dob->year, dob->month, dob->day);
+            }
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        row_avg_best = (bench_seconds(start, end) < row_avg_best) ? bench_seconds(start, end) : row_avg_best;
+        row_check = sum;
+
+        int min_age, max_age;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        column_age_summary(bench.birth_year, bench.birth_month, bench.birth_day, bench.player_count, today.year, &column_check, &min_age, &max_age);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        column_avg_best = (bench_seconds(start, end) < column_avg_best) ? bench_seconds(start, end) : column_avg_best;
+    }
+
+    int same = bench_stats_equal(&row_stats, &column_stats) && bench_stats_equal(&running_stats, &column_stats);
+
+    printf("\n========== PLAYER COLUMNS BENCHMARK ==========\n");
+    printf("[INFO] %d players in %d clubs, best of 5\n", player_count, club_count);
+    printf("[STATS] Full statistics (rows)    : %.2f ms (%zu bytes/player record)\n",
+           row_best * 1e3, sizeof(player_t));
+    printf("[STATS] Full statistics (columns) : %.2f ms (%.1fx)\n", column_best * 1e3, row_best / column_best);
+    printf("[STATS] Full statistics (running) : %.2f ms (%.1fx)\n", running_best * 1e3, row_best / running_best);
+    printf("[STATS] Age sum only (rows)       : %.2f ms\n", row_avg_best * 1e3);
+    printf("[STATS] Age sum only (columns)    : %.2f ms (%.1fx)\n", column_avg_best * 1e3, row_avg_best / column_avg_best);
+    printf("[STATS] Results match             : %s (age sum %lld / %lld)\n",
+           same ? "yes" : "NO", row_check, column_check);
+    printf("==============================================\n");
+
+    league_stats_free(&row_stats);
+    league_stats_free(&column_stats);
+    league_stats_free(&running_stats);
+    free(teams);
+    league_free(&bench);
+}
+
+// --- BULK IMPORT BENCHMARK --- //
+// The same import through stdio: a line buffer per row and sscanf for the fields
+static int bench_import_stdio(league_t *league, const char *path, size_t *players) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return 0;
+    }
+    char line[256];
+    *players = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        player_t player;
+        char club_name[21], position[20];
+        if (sscanf(line, "%20[^,],%24[^,],%d,%19[^,],%d,%d,%d", club_name, player.name, &player.kit_number,
+                   position, &player.dob.day, &player.dob.month, &player.dob.year) != CSV_FIELDS ||
+            !validate_kit_number(player.kit_number) || !validate_age(&player.dob)) {
+            continue;
+        }
+        int club = league_find_club(league, club_name);
+        if (club == -1) {
+            club = league_add_club(league, club_name);
+        }
+        if (club == -1) {
+            fclose(file);
+            return 0;
+        }
+        if (team_has_kit(&league->clubs[club], player.kit_number) ||
+            name_index_find(&league->names, league, player.name, club, 1) != NO_PLAYER) {
+            continue;
+        }
+        player.club = club;
+        player.position = league_intern_position(league, position);
+        if (player.position == -1 || league_add_player(league, &player) == NO_PLAYER) {
+            fclose(file);
+            return 0;
+        }
+        (*players)++;
+    }
+    fclose(file);
+    return 1;
+}
+
+// Writes a roster CSV of player_count synthetic players in full squads; returns its size, 0 on error
+static size_t bench_write_roster(int fd, int player_count) {
+    FILE *file = fdopen(dup(fd), "w");
+    if (file == NULL) {
+        return 0;
+    }
+    unsigned int rng = 2024;
+    fprintf(file, "club,name,kit_number,position,day,month,year\n");
+    for (int i = 0; i < player_count; i++) {
+        player_t player;
+        const char *position = bench_player(NULL, &player, i / SQUAD_SIZE, i, i % SQUAD_SIZE, &rng);
+        fprintf(file, "Club %d,%s,%d,%s,%d,%d,%d\n", i / SQUAD_SIZE, player.name, player.kit_number,
+                position, player.dob.day, player.dob.month, player.dob.year);
+    }
+    long size = ftell(file);
+    return (fclose(file) == 0 && size > 0) ? (size_t)size : 0;
+}
+
+// Mapped CSV import against a stdio import of the same file, then snapshot save and load
+void benchmark_import(int player_count) {
+    char csv_path[] = "/tmp/league_csv_XXXXXX";
+    char snapshot_path[] = "/tmp/league_snap_XXXXXX";
+    int csv_fd = mkstemp(csv_path);
+    int snapshot_fd = mkstemp(snapshot_path);
+    size_t csv_size = (csv_fd >= 0 && snapshot_fd >= 0) ? bench_write_roster(csv_fd, player_count) : 0;
+    if (csv_size == 0) {
+        handle_error("Unable to set up the import benchmark.");
+    } else {
+        printf("\n========== BULK IMPORT BENCHMARK ==========\n");
+        printf("[INFO] %d players in %d clubs, %.1f MB of CSV\n", player_count,
+               (player_count + SQUAD_SIZE - 1) / SQUAD_SIZE, csv_size / 1048576.0);
+
+        league_t stdio_league = {0}, mapped = {0}, loaded = {0};
+        import_report_t report;
+        size_t stdio_players = 0;
+        struct timespec start, end;
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        int ok = bench_import_stdio(&stdio_league, csv_path, &stdio_players);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double seconds = bench_seconds(start, end);
+        printf("[STATS] Import (fgets + sscanf) : %8.1f ms (%.1f MB/s, %zu players)\n",
+               seconds * 1e3, csv_size / seconds / 1048576.0, stdio_players);
+        league_free(&stdio_league);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        ok = ok && league_import_csv(&mapped, csv_path, &report);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        seconds = bench_seconds(start, end);
+        printf("[STATS] Import (mapped)         : %8.1f ms (%.1f MB/s, %zu players)\n",
+               seconds * 1e3, csv_size / seconds / 1048576.0, report.players_added);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        ok = ok && league_save_snapshot(&mapped, snapshot_path);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        struct stat st;
+        double snapshot_mb = (stat(snapshot_path, &st) == 0) ? st.st_size / 1048576.0 : 0.0;
+        printf("[STATS] Snapshot save           : %8.1f ms (%.1f MB)\n", bench_seconds(start, end) * 1e3, snapshot_mb);
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        ok = ok && league_load_snapshot(&loaded, snapshot_path);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        printf("[STATS] Snapshot load           : %8.1f ms\n", bench_seconds(start, end) * 1e3);
+
+        // The loaded league must answer like the imported one, and the aggregates kept during the
+        // import must match the ones recounted at load and a scan of the columns
+        league_stats_t a, b, c;
+        int same = ok && loaded.player_count == mapped.player_count && loaded.club_count == mapped.club_count &&
+                   league_compute_stats(&mapped, today.year, &a);
+        if (same) {
+            same = league_compute_stats(&loaded, today.year, &b);
+            if (same) {
+                same = league_scan_stats(&loaded, today.year, &c);
+                same = same && bench_stats_equal(&a, &b) && bench_stats_equal(&b, &c);
+                league_stats_free(&c);
+                league_stats_free(&b);
+            }
+            league_stats_free(&a);
+        }
+        for (size_t i = 0; same && i < loaded.player_count; i += 9973) {
+            same = name_index_find(&loaded.names, &loaded, league_name(&mapped, (player_handle_t)i), -1, 1) == i &&
+                   league_find_club(&loaded, loaded.clubs[loaded.club_id[i]].name) == loaded.club_id[i];
+        }
+        printf("[STATS] Loaded league matches   : %s\n", same ? "yes" : "NO");
+        printf("===========================================\n");
+        league_free(&mapped);
+        league_free(&loaded);
+    }
+    if (csv_fd >= 0) {
+        close(csv_fd);
+        unlink(csv_path);
+    }
+    if (snapshot_fd >= 0) {
+        close(snapshot_fd);
+        unlink(snapshot_path);
+    }
+}
+
+// --- CONCURRENT ACCESS BENCHMARK --- //
+typedef struct {
+    league_t *league;
+    pthread_mutex_t *writer;   // Serializes writers, as the league requires
+    pthread_rwlock_t *lock;    // Whole-league lock for the baseline; NULL for epoch readers
+    atomic_int *stop;
+    int *added;                // Players added so far, guarded by writer
+    int reader;
+    unsigned int rng;
+    long long reads, writes, checksum;
+} bench_worker_t;
+
+// One read: a name lookup (by prefix one time in eight), a kit lookup or a club summary, each on a
+// random target
+static void bench_concurrent_read(bench_worker_t *worker, unsigned int r) {
+    league_t *league = worker->league;
+    size_t players = atomic_load_explicit(&league->player_count, memory_order_acquire);
+    int clubs = atomic_load_explicit(&league->club_count, memory_order_acquire);
+    const team_t *teams = atomic_load_explicit(&league->clubs, memory_order_acquire);
+    if (r % 3 == 0 && (r >> 8) % 8 == 0) {
+        char prefix[8];
+        name_match_t matches[NAME_SEARCH_RESULTS];
+        snprintf(prefix, sizeof(prefix), "%s", league_name(league, (player_handle_t)(bench_rand(&worker->rng) % players)));
+        worker->checksum += (long long)name_search_prefix(league, prefix, matches, NAME_SEARCH_RESULTS);
+    } else if (r % 3 == 0) {
+        const char *name = league_name(league, (player_handle_t)(bench_rand(&worker->rng) % players));
+        worker->checksum += name_index_find(&league->names, league, name, -1, 0);
+    } else if (r % 3 == 1) {
+        int kit = KIT_MIN + (int)(bench_rand(&worker->rng) % KIT_MAX);
+        int first = atomic_load_explicit(&league->kit_first_club[kit], memory_order_acquire);
+        if (first != 0) {
+            worker->checksum += team_kit_player(league, &teams[first - 1], kit);
+        }
+    } else {
+        const team_t *team = &teams[bench_rand(&worker->rng) % (unsigned int)clubs];
+        const _Atomic player_handle_t *next_in_club = atomic_load_explicit(&league->next_in_club, memory_order_acquire);
+        const short *birth_year = atomic_load_explicit(&league->birth_year, memory_order_acquire);
+        const _Atomic unsigned short *position_id = atomic_load_explicit(&league->position_id, memory_order_acquire);
+        player_handle_t h = atomic_load_explicit(&team->first_player, memory_order_acquire);
+        for (; h != NO_PLAYER; h = atomic_load_explicit(&next_in_club[h], memory_order_acquire)) {
+            worker->checksum += today.year - birth_year[h] + atomic_load_explicit(&position_id[h], memory_order_relaxed);
+        }
+    }
+}
+
+// One write: enrolls a player (opening a club every SQUAD_SIZE players) or moves one to another position
+static void bench_concurrent_write(bench_worker_t *worker, unsigned int r) {
+    static const char *positions[] = {"Goalkeeper", "Defender", "Midfielder", "Forward", "Winger"};
+    league_t *league = worker->league;
+    pthread_mutex_lock(worker->writer);
+    if (r % 2 == 0) {
+        player_t player;
+        int serial = BENCH_PLAYERS + *worker->added;
+        if ((*worker->added % SQUAD_SIZE != 0 || league_add_club(league, "Bench FC") != -1) &&
+            bench_player(league, &player, league->club_count - 1, serial, *worker->added % SQUAD_SIZE, &worker->rng) != NULL &&
+            league_add_player(league, &player) != NO_PLAYER) {
+            ++*worker->added;
+        }
+    } else {
+        player_handle_t player = (player_handle_t)(bench_rand(&worker->rng) % league->player_count);
+        league_set_position(league, player, positions[(r >> 8) % 5]);
+    }
+    pthread_mutex_unlock(worker->writer);
+}
+
+// Mixed workload until told to stop: nine reads to one write
+static void *bench_concurrent_worker(void *arg) {
+    bench_worker_t *worker = arg;
+    while (!atomic_load_explicit(worker->stop, memory_order_relaxed)) {
+        unsigned int r = bench_rand(&worker->rng);
+        int write = (r >> 4) % 10 == 0;
+        if (worker->lock != NULL) {
+            if (write) {
+                pthread_rwlock_wrlock(worker->lock);
+                bench_concurrent_write(worker, r);
+            } else {
+                pthread_rwlock_rdlock(worker->lock);
+                bench_concurrent_read(worker, r);
+            }
+            pthread_rwlock_unlock(worker->lock);
+        } else if (write) {
+            bench_concurrent_write(worker, r);
+        } else {
+            league_read_begin(worker->league, worker->reader);
+            bench_concurrent_read(worker, r);
+            league_read_end(worker->league, worker->reader);
+        }
+        if (write) {
+            worker->writes++;
+        } else {
+            worker->reads++;
+        }
+    }
+    return NULL;
+}
+
+// Runs the workload on thread_count threads for BENCH_CONCURRENT_SECONDS; returns operations per second
+static double bench_concurrent_run(league_t *league, int thread_count, pthread_rwlock_t *lock, int *added,
+                                   long long *checksum) {
+    pthread_t threads[READER_SLOTS];
+    bench_worker_t workers[READER_SLOTS];
+    pthread_mutex_t writer = PTHREAD_MUTEX_INITIALIZER;
+    atomic_int stop = 0;
+    struct timespec start, end;
+    struct timespec duration = {0, (long)(BENCH_CONCURRENT_SECONDS * 1e9)};
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int started = 0;
+    for (; started < thread_count; started++) {
+        workers[started] = (bench_worker_t){league, &writer, lock, &stop, added, started, 2024u + (unsigned int)started * 7919u, 0, 0, 0};
+        if (pthread_create(&threads[started], NULL, bench_concurrent_worker, &workers[started]) != 0) {
+            break;
+        }
+    }
+    nanosleep(&duration, NULL);
+    atomic_store(&stop, 1);
+    long long operations = 0;
+    for (int t = 0; t < started; t++) {
+        pthread_join(threads[t], NULL);
+        operations += workers[t].reads + workers[t].writes;
+        *checksum += workers[t].checksum;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    pthread_mutex_destroy(&writer);
+    return started == thread_count ? operations / bench_seconds(start, end) : 0.0;
+}
+
+// Lock-free readers against a reader-writer lock over the whole league, from one thread up to max_threads
+void benchmark_concurrent(int max_threads) {
+    league_t bench = {0};
+    unsigned int rng = 2024;
+    if (!bench_fill_league(&bench, BENCH_PLAYERS, &rng)) {
+        league_free(&bench);
+        return;
+    }
+    max_threads = (max_threads < READER_SLOTS) ? max_threads : READER_SLOTS;
+
+    printf("\n========== CONCURRENT ACCESS BENCHMARK ==========\n");
+    printf("[INFO] %d players in %d clubs, 90%% reads / 10%% writes, %.1f s per run\n",
+           BENCH_PLAYERS, bench.club_count, BENCH_CONCURRENT_SECONDS);
+    pthread_rwlock_t lock;
+    pthread_rwlock_init(&lock, NULL);
+    int added = 0;
+    long long checksum = 0;
+    double single = 0.0;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        double epoch = bench_concurrent_run(&bench, threads, NULL, &added, &checksum);
+        double locked = bench_concurrent_run(&bench, threads, &lock, &added, &checksum);
+        if (epoch == 0.0 || locked == 0.0) {
+            handle_error("Unable to start the benchmark threads.");
+            break;
+        }
+        single = (threads == 1) ? epoch : single;
+        printf("[STATS] %2d thread%s : %10.0f ops/s epoch (%.2fx), %10.0f ops/s rwlock\n",
+               threads, threads == 1 ? " " : "s", epoch, epoch / single, locked);
+    }
+    printf("[INFO] %d players added during the runs (checksum %lld)\n", added, checksum);
+    printf("=================================================\n");
+    pthread_rwlock_destroy(&lock);
+    league_free(&bench);
+}
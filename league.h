@@ -0,0 +1,362 @@
+// League library: club and player storage, name indexes and search, running statistics, bulk
+// import, snapshots and the batch command runner. The interactive program in main (3).c drives it.
+#ifndef LEAGUE_H
+#define LEAGUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+// --- CORE CONSTANTS --- //
+#define NUM_TEAMS 10          // Maximum number of teams in the league
+#define AGE_BINS (AGE_MAX - AGE_MIN + 1) // League age histogram buckets, one per allowed age
+#define NAME_INDEX_MIN_SLOTS 64 // Initial size of the player name index
+#define BENCH_PLAYERS 1000000 // Synthetic players used by --bench-index and --bench-columns
+#define BENCH_CLUBS 100000    // Synthetic clubs used by --bench-arena
+#define STATS_LANES 16        // Independent accumulators in the column reductions
+#define CSV_FIELDS 7          // club,name,kit_number,position,day,month,year
+#define IMPORT_ERRORS_SHOWN 10 // Rejected rows reported one by one during an import
+#define BENCH_IMPORT_PLAYERS 2000000 // Default size of the --bench-import league
+#define SNAPSHOT_MAGIC "LEAGSNP1" // First bytes of a league snapshot file
+#define SNAPSHOT_VERSION 3
+#define BATCH_OUTPUT_BUFFER (1 << 20) // Bytes of batch results collected before they are written
+#define READER_SLOTS 64       // Threads that can read the league at the same time
+#define BENCH_CONCURRENT_SECONDS 0.5 // Length of each --bench-concurrent run
+#define BIRTH_YEAR_FIRST 1900 // First year of the league's birth year counts
+#define BIRTH_YEARS 256       // Years counted; earlier and later years go to the end counts
+#define NAME_SEARCH_MAX 24    // Longest player name
+#define NAME_SEARCH_EDITS 2   // Misspellings tolerated by fuzzy name search
+#define NAME_SEARCH_RESULTS 5 // Candidates shown for a name search
+#define NAME_ORDER_MIN_TAIL 1024 // Unsorted players tolerated before the name order is merged
+#define NAME_ORDER_TAIL_SHARE 64 // ... or this fraction of the sorted ones, whichever is more
+#define TRIGRAM_BITS 16       // log2 of the trigram buckets
+#define FUZZY_LETTERS_PER_EDIT 6 // Query letters needed for each edit fuzzy search tolerates
+#define NO_PLAYER 0xFFFFFFFFu // Handle value meaning "no player"
+
+// --- LEAGUE RULES --- //
+// The rule limits are compiled into the validators. A build picks a league profile with
+// -DLEAGUE_PROFILE=LEAGUE_YOUTH (or LEAGUE_VETERANS), and can override single limits (-DAGE_MAX=40).
+#define LEAGUE_SENIOR 1
+#define LEAGUE_YOUTH 2
+#define LEAGUE_VETERANS 3
+#ifndef LEAGUE_PROFILE
+#define LEAGUE_PROFILE LEAGUE_SENIOR
+#endif
+
+#if LEAGUE_PROFILE == LEAGUE_SENIOR
+#define PROFILE_SQUAD_SIZE 15
+#define PROFILE_KIT_MIN 1
+#define PROFILE_KIT_MAX 99
+#define PROFILE_AGE_MIN 16
+#define PROFILE_AGE_MAX 45
+#elif LEAGUE_PROFILE == LEAGUE_YOUTH
+#define PROFILE_SQUAD_SIZE 18
+#define PROFILE_KIT_MIN 1
+#define PROFILE_KIT_MAX 40
+#define PROFILE_AGE_MIN 12
+#define PROFILE_AGE_MAX 18
+#elif LEAGUE_PROFILE == LEAGUE_VETERANS
+#define PROFILE_SQUAD_SIZE 20
+#define PROFILE_KIT_MIN 1
+#define PROFILE_KIT_MAX 99
+#define PROFILE_AGE_MIN 35
+#define PROFILE_AGE_MAX 70
+#else
+#error "Unknown LEAGUE_PROFILE"
+#endif
+
+#ifndef SQUAD_SIZE
+#define SQUAD_SIZE PROFILE_SQUAD_SIZE // Maximum players per team as per rules
+#endif
+#ifndef KIT_MIN
+#define KIT_MIN PROFILE_KIT_MIN // Minimum kit number as per rules
+#endif
+#ifndef KIT_MAX
+#define KIT_MAX PROFILE_KIT_MAX // Maximum kit number as per rules
+#endif
+#ifndef AGE_MIN
+#define AGE_MIN PROFILE_AGE_MIN // Minimum player age as per the rules
+#endif
+#ifndef AGE_MAX
+#define AGE_MAX PROFILE_AGE_MAX // Maximum player age as per the rules
+#endif
+#define KIT_NUMBERS (KIT_MAX - KIT_MIN + 1) // Kit numbers a squad can choose from
+
+_Static_assert(0 <= KIT_MIN && KIT_MIN <= KIT_MAX && KIT_MAX < 128, "Kit numbers are stored in a byte and a 128-bit set per squad");
+_Static_assert(0 <= AGE_MIN && AGE_MIN <= AGE_MAX && AGE_MAX < 200, "Age limits out of range");
+_Static_assert(0 < SQUAD_SIZE && SQUAD_SIZE <= KIT_NUMBERS, "Every player in a squad needs a kit number of its own");
+
+// Rule messages, with the limits spelled out at compile time
+#define RULE_TEXT(limit) RULE_TEXT_(limit)
+#define RULE_TEXT_(limit) #limit
+#define KIT_RULE "Invalid kit number. Range: " RULE_TEXT(KIT_MIN) " - " RULE_TEXT(KIT_MAX) "."
+#define AGE_RULE "Invalid date of birth. Age range: " RULE_TEXT(AGE_MIN) " - " RULE_TEXT(AGE_MAX) " years."
+
+// --- STRUCTURE DEFINITIONS --- //
+typedef unsigned int player_handle_t; // Index of a player in the league's columns
+
+typedef struct {
+    int day, month, year;     // Date of Birth format: Day, Month, Year
+} age_t;
+
+// One player as entered; the league stores it split into columns. Club and position are ids
+// into the league (see league_find_club and league_intern_position), not copies of their names.
+typedef struct {
+    char name[25];            // Full player name with limit
+    int kit_number;           // Unique kit number
+    int club;                 // Club id
+    age_t dob;                // Player's date of birth
+    int position;             // Player's preferred position, as a position id
+} player_t;
+
+// Fields that change after a club is enrolled are atomic, so readers can walk a squad while it grows
+typedef struct {
+    char name[21];            // Team name (up to 20 characters)
+    atomic_int active_size;   // Number of players in the team
+    _Atomic player_handle_t first_player; // Squad in enrollment order, linked through next_in_club
+    _Atomic player_handle_t last_player;
+    atomic_ullong kit_bits[2]; // Kit numbers taken in this squad, bit per number
+    atomic_llong birth_year_sum; // Age sum at a reference year = active_size x year - this (see league_stats_t)
+    atomic_int min_birth_year; // Valid when the squad has players
+    atomic_int max_birth_year;
+} team_t;
+
+// --- PLAYER NAME INDEX --- //
+typedef struct {
+    atomic_uint hash;         // Case-folded name hash
+    _Atomic player_handle_t player; // Indexed player, NO_PLAYER for an empty slot; stored last
+} name_slot_t;
+
+typedef struct {
+    size_t capacity;          // Number of slots, a power of two
+    name_slot_t slots[];      // Open-addressing table
+} name_table_t;
+
+typedef struct {
+    name_table_t *_Atomic table; // Replaced as a whole when the index grows
+    size_t count;             // Players indexed
+} name_index_t;
+
+// Club or position ids by exact name, so a name is compared once and then carried as a small integer
+typedef struct {
+    size_t capacity;          // Number of slots, a power of two
+    atomic_int slots[];       // Ids, -1 for an empty slot
+} id_table_t;
+
+// --- PLAYER NAME SEARCH --- //
+// Players sorted by case-folded name, for prefix queries. Handles are given out in order, so the
+// players added since the last merge are exactly the handles from count on; they are scanned.
+typedef struct {
+    size_t count;
+    player_handle_t handles[];
+} name_order_t;
+
+// Players with a name trigram in one bucket, in handle order
+typedef struct {
+    atomic_uint count;
+    unsigned int capacity;
+    player_handle_t *_Atomic players;
+} trigram_list_t;
+
+typedef struct {
+    name_order_t *_Atomic order;
+    trigram_list_t *_Atomic buckets; // 1 << TRIGRAM_BITS lists, allocated with the first player
+} name_search_t;
+
+// One ranked search result
+typedef struct {
+    player_handle_t player;
+    int distance;             // Letters past the prefix, or edits from the fuzzy query
+} name_match_t;
+
+// --- CONCURRENT ACCESS --- //
+// Readers never lock. Writers (serialized by the caller) replace an array that has to grow with a
+// copy instead of reallocating it, and the old array is freed once every reader that might still
+// hold it has left the league. Readers announce themselves in an epoch slot for that purpose.
+typedef struct {
+    _Alignas(64) atomic_ullong epoch; // League epoch + 1 when the reader entered, 0 when outside
+} reader_slot_t;
+
+typedef struct retired {
+    struct retired *next;
+    unsigned long long epoch; // League epoch when the memory was replaced
+    void *memory;
+} retired_t;
+
+// --- LEAGUE STORAGE --- //
+// Players per club and position: a row of `positions` counts for every club the league has room for
+typedef struct {
+    int positions;
+    atomic_int counts[];
+} position_tally_t;
+
+// Players are stored column by column, indexed by handle, so a statistic only reads the fields it
+// uses (a few bytes per player instead of a whole player_t). Resetting keeps every allocation.
+// Columns are written once, before the player is published; only next_in_club and position_id change
+// afterwards, so only those hold atomics.
+typedef struct {
+    team_t *_Atomic clubs;    // Enrolled clubs, indexed by club id
+    atomic_int club_count;
+    int club_capacity;
+
+    atomic_size_t player_count; // Players stored; the next handle to hand out
+    size_t player_capacity;   // Rows allocated in every column
+    short *_Atomic birth_year;
+    unsigned char *_Atomic birth_month;
+    unsigned char *_Atomic birth_day;
+    unsigned char *_Atomic kit_number;
+    int *_Atomic club_id;
+    _Atomic unsigned short *_Atomic position_id; // Into positions
+    unsigned int *_Atomic name_offset; // Into name_pool
+    _Atomic player_handle_t *_Atomic next_in_club; // Next player of the same club, in enrollment order
+
+    char *_Atomic name_pool;  // Every player name, NUL-terminated, back to back
+    size_t name_pool_used;
+    size_t name_pool_capacity;
+    char (*_Atomic positions)[20]; // Interned position names, indexed by position id
+    atomic_int position_count;
+    int position_capacity;
+    id_table_t *position_names; // Every position, by name (writer only)
+
+    name_index_t names;       // Every player, by case-insensitive name
+    name_search_t search;     // Every player, by name prefix and by name trigrams
+    id_table_t *_Atomic club_names; // Every club, by exact name
+    atomic_int kit_first_club[KIT_MAX + 1]; // Lowest club id + 1 that has each kit number, 0 if none
+
+    // Running aggregates, kept up to date as players are added or change position. Birth years are
+    // counted a year later for players whose birthday is still ahead of today, so they give exact ages.
+    position_tally_t *_Atomic position_tally;
+    atomic_llong birth_year_sum;
+    atomic_int min_birth_year; // Valid when the league has players
+    atomic_int max_birth_year;
+    atomic_int birth_year_counts[BIRTH_YEARS]; // From BIRTH_YEAR_FIRST
+
+    atomic_ullong epoch;      // Advanced each time memory is retired
+    retired_t *retired;       // Replaced arrays not yet freed (writer only)
+    reader_slot_t readers[READER_SLOTS];
+} league_t;
+
+// League statistics at a reference year, read from the running aggregates or scanned from the columns.
+// Ages are taken on today's month and day of that year, so for today.year they are the exact ages the
+// player listings show.
+typedef struct {
+    int club_count;
+    int position_count;
+    long long *age_sum;       // Per club
+    int *min_age;             // Per club, valid when the club has players
+    int *max_age;
+    int *position_counts;     // club_count x position_count, row per club
+    long long total_age;      // League wide
+    int min_age_all;
+    int max_age_all;
+    int age_histogram[AGE_BINS]; // Ages outside the rules are counted in the end buckets
+} league_stats_t;
+
+// Outcome of a bulk import
+typedef struct {
+    size_t lines;             // Lines read, blank ones included
+    size_t clubs_added;
+    size_t players_added;
+    size_t rejected;          // Rows that broke a rule or could not be parsed
+} import_report_t;
+
+// --- LEAGUE SNAPSHOT --- //
+// Header of a snapshot file; the league's arrays follow in league_t order, each one packed
+typedef struct {
+    char magic[8];            // SNAPSHOT_MAGIC
+    uint32_t version;         // SNAPSHOT_VERSION
+    uint32_t team_size;       // sizeof(team_t) of the writer
+    uint64_t club_count;
+    uint64_t player_count;
+    uint64_t name_pool_size;  // Bytes of player names
+    uint64_t position_count;
+    uint64_t name_slots;      // Name index capacity (0 or a power of two)
+    uint64_t name_order;      // Players in the sorted name order
+    uint64_t trigram_buckets; // 0 or 1 << TRIGRAM_BITS
+    uint64_t trigram_postings; // Players in all trigram lists together
+    uint16_t kit_min, kit_max; // Rules of the writer, which the reader has to share
+    uint16_t age_min, age_max;
+} snapshot_header_t;
+
+// --- GLOBAL VARIABLES --- //
+extern league_t league;       // The league being managed
+extern age_t today;           // Date ages are counted on, read at startup; fixed for the run, as the running statistics count birthdays against it
+
+// --- FUNCTION PROTOTYPES --- //
+void display_menu();
+void enroll_club();
+void add_player();
+void search_update();
+void display_club_statistics(int list_players);
+void handle_error(const char *message);
+age_t current_date();
+int age_on(const age_t *dob, const age_t *date);
+int get_club_index();
+void update_player_position(player_handle_t player);
+
+int league_add_club(league_t *league, const char *name);
+player_handle_t league_add_player(league_t *league, const player_t *player);
+int league_find_club(const league_t *league, const char *name);
+const char *league_name(const league_t *league, player_handle_t player);
+int league_age(const league_t *league, player_handle_t player);
+int league_intern_position(league_t *league, const char *position);
+int league_set_position(league_t *league, player_handle_t player, const char *position);
+void league_read_begin(league_t *league, int reader);
+void league_read_end(league_t *league, int reader);
+int team_has_kit(const team_t *team, int kit_number);
+player_handle_t team_kit_player(const league_t *league, const team_t *team, int kit_number);
+size_t league_memory(const league_t *league);
+void league_reset(league_t *league);
+void league_free(league_t *league);
+
+int league_compute_stats(const league_t *league, int reference_year, league_stats_t *stats);
+int league_scan_stats(const league_t *league, int reference_year, league_stats_t *stats);
+void league_stats_free(league_stats_t *stats);
+
+int league_import_csv(league_t *league, const char *path, import_report_t *report);
+int league_save_snapshot(const league_t *league, const char *path);
+int league_load_snapshot(league_t *league, const char *path);
+int run_batch(const char *path);
+
+unsigned int name_hash(const char *name);
+name_table_t *name_table_new(size_t capacity);
+int name_index_insert(name_index_t *index, league_t *league, player_handle_t player);
+player_handle_t name_index_find(const name_index_t *index, const league_t *league, const char *name, int club, int case_sensitive);
+void name_index_free(name_index_t *index);
+int name_search_insert(name_search_t *search, league_t *league, player_handle_t player);
+void name_order_merge(name_search_t *search, league_t *league);
+void name_search_reset(name_search_t *search);
+size_t name_search_memory(const name_search_t *search);
+size_t name_search_prefix(const league_t *league, const char *prefix, name_match_t *matches, size_t limit);
+size_t name_search_fuzzy(const league_t *league, const char *name, int max_edits, name_match_t *matches, size_t limit);
+void name_search_free(name_search_t *search);
+void benchmark_player_index();
+void benchmark_league_storage();
+void benchmark_player_columns();
+void benchmark_import(int player_count);
+void benchmark_concurrent(int max_threads);
+
+// --- VALIDATE KIT NUMBER --- //
+// The limits are compile-time constants, so this folds into a single unsigned compare
+static inline int validate_kit_number(int kit_number) {
+    return (unsigned int)(kit_number - KIT_MIN) <= (unsigned int)(KIT_MAX - KIT_MIN);
+}
+
+// --- VALIDATE PLAYER AGE --- //
+// The date has to exist and the player has to be between AGE_MIN and AGE_MAX years old today: born
+// after today's date AGE_MAX + 1 years ago and no later than today's date AGE_MIN years ago. Dates
+// are compared as year:month:day keys, so that is two compares once the year is known to be close
+// enough for the key not to overflow.
+static inline int validate_age(const age_t *dob) {
+    static const int month_days[12] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (dob->year < today.year - AGE_MAX - 1 || dob->year > today.year - AGE_MIN ||
+        dob->month < 1 || dob->month > 12 || dob->day < 1 || dob->day > month_days[dob->month - 1] ||
+        (dob->month == 2 && dob->day == 29 && (dob->year % 4 != 0 || (dob->year % 100 == 0 && dob->year % 400 != 0)))) {
+        return 0;
+    }
+    int born = dob->year * 512 + dob->month * 32 + dob->day;
+    int now = today.year * 512 + today.month * 32 + today.day;
+    return born > now - (AGE_MAX + 1) * 512 && born <= now - AGE_MIN * 512;
+}
+
+#endif
@@ -1,125 +1,153 @@
-
-#include <stdio.h>
-#include <time.h>
-
-// --- CORE PARAMETERS --- //
-#define BASE_BALANCE 1000            // Default starting balance
-#define TRANSACTION_LIMIT 100        // Maximum allowable bank account transactions
-
-// --- FUNCTION DECLARATIONS --- //
-void execute_transactions(const int txn_list[], int txn_count);
-void log_transaction(int txn_id, int txn_value, int current_balance);
-void display_pending(const int pending_txn[], int count);
-void show_summary(int deposits, int withdrawals, int failed_txns);
-const char* get_time_stamp(); // For adding timestamps to the logs
-
-// --- ENTRY POINT --- //
-int main() {
-    // Array of transaction values: positive for deposits, negative for withdrawals
-    int txn_data[] = {200, -150, -500, -400, -50, -200, 300};
-    int txn_count = sizeof(txn_data) / sizeof(txn_data[0]);
-
-    // System boot: Initialize transaction processing
-    printf(">>[INIT] Activating Banking Terminal...\n");
-    printf("[SECURE] System Timestamp: %s\n", get_time_stamp());
-    execute_transactions(txn_data, txn_count);
-    printf("\n[SHUTDOWN] Banking Terminal Offline.\n");
-
-    return 0;
-}
-
-// --- TRANSACTION PROCESSING --- //
-void execute_transactions(const int txn_list[], int txn_count) {
-    int balance = BASE_BALANCE;          // Initializes the user balance
-    int pending_txn[TRANSACTION_LIMIT]; // Stores the unprocessed transactions
-    int pending_count = 0;              // Counter for the pending transactions
-
-    int total_deposits = 0;             // Total amount deposited 
-    int total_withdrawals = 0;          // Total amount withdrawn
-    int failed_txns = 0;                // Total number of failed transactions
-
-    printf("\n========== TRANSACTION LOG ==========\n");
-    printf("[INFO] Account Balance Initialized: %d AED\n", balance);
-
-    // Iterates through all the transactions
-    for (int i = 0; i < txn_count; i++) {
-        int txn = txn_list[i];
-
-        // Stops processing if the account balance hits zero
-        if (balance == 0) {
-            printf("[CRITICAL] Balance exhausted. Cannot process further transactions.\n");
-            pending_txn[pending_count++] = txn;
-            failed_txns++;
-            continue;
-        }
-
-        // Processing withdrawals (negative values)
-        if (txn < 0) {
-            if (balance + txn < 0) {
-                // Insufficient balance for withdrawal
-                printf("[FAILED] Txn %d: Withdrawal of %d AED declined (Insufficient Funds).\n", i + 1, -txn);
-                pending_txn[pending_count++] = txn;
-                failed_txns++;
-            } else {
-                // Execute withdrawal transaction
-                balance += txn;
-                total_withdrawals += -txn; // Track withdrawal amount
-                log_transaction(i + 1, txn, balance);
-            }
-        } else {
-            // Processing deposits (positive values)
-            balance += txn;
-            total_deposits += txn; // Tracks the deposit amount
-            log_transaction(i + 1, txn, balance);
-        }
-    }
-
-    // Final summary
-    printf("\n========== PROCESSING COMPLETE ==========\n");
-    printf("[INFO] Final Account Balance: %d AED.\n", balance);
-
-    if (pending_count > 0) {
-        printf("[NOTICE] Some transactions remain unprocessed.\n");
-        display_pending(pending_txn, pending_count);
-    } else {
-        printf("[SUCCESS] All transactions completed successfully.\n");
-    }
-
-    // Displays the transaction summary to the user
-    show_summary(total_deposits, total_withdrawals, failed_txns);
-}
-
-// --- TRANSACTION LOGGER --- //
-void log_transaction(int txn_id, int txn_value, int current_balance) {
-    // Logs each transaction with type (deposit/withdrawal) and updated balance
-    printf("[TXN] Transaction %d: %s of %d AED\n", 
-           txn_id, 
-           (txn_value < 0) ? "Withdrawal" : "Deposit", 
-           (txn_value < 0) ? -txn_value : txn_value);
-    printf("      Updated Balance: %d AED\n", current_balance);
-}
-
-// --- DISPLAY PENDING TRANSACTIONS --- //
-void display_pending(const int pending_txn[], int count) {
-    // Output of all the unprocessed transactions
-    for (int i = 0; i < count; i++) {
-        printf("[PENDING] Unprocessed Transactions >> %d AED.\n", pending_txn[i]);
-    }
-}
-
-// --- TRANSACTION SUMMARY --- //
-void show_summary(int deposits, int withdrawals, int failed_txns) {
-    printf("\n========== TRANSACTION SUMMARY ==========\n");
-    printf("[DATA] Total Deposits      : %d AED\n", deposits);
-    printf("[DATA] Total Withdrawals   : %d AED\n", withdrawals);
-    printf("[DATA] Failed Transactions : %d\n", failed_txns);
-}
-
-// --- GET CURRENT TIMESTAMP --- //
-const char* get_time_stamp() {
-    static char buffer[20];
-    time_t t = time(NULL);
-    struct tm* time_info = localtime(&t);
-    strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", time_info);
-    return buffer;
-}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "bank_terminal.h"
+
+// Prints the command line summary; returns the exit status for bad arguments
+static int usage(const char *program) {
+    fprintf(stderr, "Usage: %s [--quiet] [--stats] [--log-policy sync|block|drop|count] [--retry none|deposit|end] [--max-retries N] [--accounts [--shards N]]\n"
+                    "       [--stream FILE|- | --replay LEDGER [--resume]] | --convert CSV LEDGER\n"
+                    "       | --bench [COUNT] | --bench-shards | --bench-replay [COUNT] | --bench-ingest [PRODUCERS]\n"
+                    "       | --bench-instr [COUNT] | --bench-log [COUNT]\n", program);
+    return 1;
+}
+
+// Parses a whole non-negative decimal int; false on sign, garbage or overflow
+static bool parse_count(const char *text, int *out) {
+    char *end;
+    errno = 0;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || errno != 0 || value < 0 || value > INT_MAX) {
+        return false;
+    }
+    *out = (int)value;
+    return true;
+}
+
+// --- ENTRY POINT --- //
+int main(int argc, char *argv[]) {
+    bool quiet = false;
+    bool accounts = false;
+    int shards = 0;
+    const char *stream_path = NULL;
+    const char *replay_path = NULL;
+    bool resume = false;
+
+    // Command line: [--quiet] [--stats] [--log-policy sync|block|drop|count] [--retry none|deposit|end] [--max-retries N] [--accounts [--shards N]]
+    //               [--stream FILE|- | --replay LEDGER [--resume]] | --convert CSV LEDGER
+    //               | --bench [COUNT] | --bench-shards | --bench-replay [COUNT] | --bench-ingest [PRODUCERS]
+    //               | --bench-instr [COUNT] | --bench-log [COUNT]
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            phase_stats_enable();
+        } else if (strcmp(argv[i], "--log-policy") == 0 && i + 1 < argc) {
+            const char *policy = argv[++i];
+            if (strcmp(policy, "sync") == 0) {
+                log_policy = LOG_SYNC;
+            } else if (strcmp(policy, "block") == 0) {
+                log_policy = LOG_BLOCK;
+            } else if (strcmp(policy, "drop") == 0) {
+                log_policy = LOG_DROP;
+            } else if (strcmp(policy, "count") == 0) {
+                log_policy = LOG_COUNT;
+            } else {
+                fprintf(stderr, "[ERROR] Unknown log policy: %s\n", policy);
+                return usage(argv[0]);
+            }
+        } else if (strcmp(argv[i], "--accounts") == 0) {
+            accounts = true;
+        } else if (strcmp(argv[i], "--retry") == 0 && i + 1 < argc) {
+            const char *mode = argv[++i];
+            if (strcmp(mode, "none") == 0) {
+                retry_policy.mode = RETRY_NONE;
+            } else if (strcmp(mode, "deposit") == 0) {
+                retry_policy.mode = RETRY_ON_DEPOSIT;
+            } else if (strcmp(mode, "end") == 0) {
+                retry_policy.mode = RETRY_AT_END;
+            } else {
+                fprintf(stderr, "[ERROR] Unknown retry mode: %s\n", mode);
+                return usage(argv[0]);
+            }
+        } else if (strcmp(argv[i], "--max-retries") == 0 && i + 1 < argc) {
+            if (!parse_count(argv[++i], &retry_policy.max_attempts)) {
+                fprintf(stderr, "[ERROR] Invalid retry count: %s\n", argv[i]);
+                return usage(argv[0]);
+            }
+        } else if (strcmp(argv[i], "--shards") == 0 && i + 1 < argc) {
+            shards = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--stream") == 0 && i + 1 < argc) {
+            stream_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--resume") == 0) {
+            resume = true;
+        } else if (strcmp(argv[i], "--convert") == 0 && i + 2 < argc) {
+            return convert_csv_ledger(argv[i + 1], argv[i + 2]);
+        } else if (strcmp(argv[i], "--bench") == 0) {
+            benchmark_batches(i + 1 < argc ? atoll(argv[i + 1]) : 100000000LL);
+            return 0;
+        } else if (strcmp(argv[i], "--bench-shards") == 0) {
+            benchmark_sharded();
+            return 0;
+        } else if (strcmp(argv[i], "--bench-replay") == 0) {
+            benchmark_replay(i + 1 < argc ? atoll(argv[i + 1]) : 8000000LL);
+            return 0;
+        } else if (strcmp(argv[i], "--bench-ingest") == 0) {
+            int producers = (i + 1 < argc) ? atoi(argv[i + 1]) : 4;
+            benchmark_ingest(producers > 0 ? producers : 1);
+            return 0;
+        } else if (strcmp(argv[i], "--bench-instr") == 0) {
+            benchmark_instrumentation(i + 1 < argc ? atoll(argv[i + 1]) : 4000000LL);
+            return 0;
+        } else if (strcmp(argv[i], "--bench-log") == 0) {
+            benchmark_logging(i + 1 < argc ? atoll(argv[i + 1]) : 4000000LL);
+            return 0;
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (shards <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN); // One shard per core by default
+        shards = (online > 0) ? (int)online : 1;
+    }
+
+    // Replay mode: transactions come from a memory-mapped binary ledger file
+    if (replay_path != NULL) {
+        return accounts ? execute_account_replay(replay_path, shards) : execute_ledger_replay(replay_path, quiet, resume);
+    }
+
+    // Streaming mode: transactions come from a file or stdin instead of txn_data[]
+    if (stream_path != NULL) {
+        int fd = (strcmp(stream_path, "-") == 0) ? STDIN_FILENO : open(stream_path, O_RDONLY);
+        if (fd < 0) {
+            fprintf(stderr, "[ERROR] Cannot open %s: %s\n", stream_path, strerror(errno));
+            return 1;
+        }
+        // Multi-account input is "account amount" pairs; the sharded ledger reports totals only
+        int status = accounts ? execute_account_stream(fd, shards) : execute_transaction_stream(fd, quiet);
+        if (fd != STDIN_FILENO) {
+            close(fd);
+        }
+        return status;
+    }
+
+    // Array of transaction values: positive for deposits, negative for withdrawals
+    int txn_data[] = {200, -150, -500, -400, -50, -200, 300};
+    int txn_count = sizeof(txn_data) / sizeof(txn_data[0]);
+
+    // System boot: Initialize transaction processing
+    printf(">>[INIT] Activating Banking Terminal...\n");
+    printf("[SECURE] System Timestamp: %s\n", get_time_stamp());
+    execute_transactions(txn_data, txn_count);
+    printf("\n[SHUTDOWN] Banking Terminal Offline.\n");
+
+    return 0;
+}